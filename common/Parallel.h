@@ -0,0 +1,21 @@
+#pragma once
+
+#include <vector>
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+
+// Calls function(from, to) on about equal parts of [0, count), each on its own thread;
+// the first part runs on the calling thread, so one thread starts none.
+template <typename Function>
+void splitBetweenThreads(size_t count, size_t threads, Function function) {
+    threads = std::max<size_t>(1, std::min(threads, count));
+    std::vector<std::thread> workers;
+    for (size_t i = 1; i < threads; ++i) {
+        workers.emplace_back(function, count * i / threads, count * (i + 1) / threads);
+    }
+    function(0, count / threads);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
@@ -0,0 +1,288 @@
+#pragma once
+
+#include <algorithm>
+#include <string>
+#include <string_view>
+#include <vector>
+#include "../task_1/PrefixFunction.h"
+
+inline std::vector<int> prefixToZ(const std::vector<int>& prefix_function) {
+    std::vector<int> z_function(prefix_function.size(), 0);
+    z_function[0] = z_function.size();
+    for (int i = 1; i < prefix_function.size(); ++i) {
+        if (prefix_function[i]) {
+            z_function[i - prefix_function[i] + 1] = prefix_function[i];
+        }
+    }
+    for (int i = 1; i < z_function.size();) {
+        if (z_function[i] == 0) {
+            ++i;
+            continue;
+        }
+        int skip = 0;
+        for (int j = 1; j < z_function[i]; ++j) {
+            if (z_function[j] < z_function[i + j]) {
+                break;
+            }
+            z_function[i + j] = std::min(z_function[j], z_function[i] - j);
+            skip = j;
+        }
+        i += skip + 1;
+    }
+    return z_function;
+}
+
+// Each position is visited once: either as the start of a z-box or while copying
+// values inside the box of its closest known start, so the whole pass is O(n).
+inline std::vector<int> prefixToZLinear(const std::vector<int>& prefix_function) {
+    const int size = prefix_function.size();
+    std::vector<int> z_function(size, 0);
+    if (size == 0) {
+        return z_function;
+    }
+    for (int i = 1; i < size; ++i) {
+        if (prefix_function[i]) {
+            int start = i - prefix_function[i] + 1;
+            z_function[start] = std::max(z_function[start], prefix_function[i]);
+        }
+    }
+    z_function[0] = size;
+    for (int i = 1; i < size;) {
+        int box = z_function[i];
+        int j = 1;
+        for (; j < box; ++j) {
+            if (z_function[i + j] > z_function[j]) {
+                break;                          //a longer box starts here and covers the rest
+            }
+            z_function[i + j] = std::min(z_function[j], box - j);
+        }
+        i += j;
+    }
+    return z_function;
+}
+
+// Walks every z-box right to left and stops at the first already filled position,
+// which is already covered by a box starting earlier, so every cell is written once.
+inline std::vector<int> zToPrefixLinear(const std::vector<int>& z_function) {
+    const int size = z_function.size();
+    std::vector<int> prefix_function(size, 0);
+    for (int i = 1; i < size; ++i) {
+        for (int j = z_function[i] - 1; j >= 0 && !prefix_function[i + j]; --j) {
+            prefix_function[i + j] = j + 1;
+        }
+    }
+    return prefix_function;
+}
+
+// An array is a prefix function iff the string with the fewest forced equalities
+// (a fresh symbol wherever the value is zero) has exactly this prefix function.
+inline bool isPrefixFunction(const std::vector<int>& prefix_function) {
+    const int size = prefix_function.size();
+    if (!size) {
+        return true;                        //of the empty string, as for isZFunction
+    }
+    if (prefix_function[0] != 0) {
+        return false;
+    }
+    std::vector<int> symbols(size);
+    int fresh_symbol = 0;
+    for (int i = 0; i < size; ++i) {
+        int value = prefix_function[i];
+        if (value < 0 || value > i) {
+            return false;
+        }
+        symbols[i] = value ? symbols[value - 1] : fresh_symbol++;
+    }
+    return stringToPrefix(symbols) == prefix_function;
+}
+
+// Same idea for z-functions: copy from the furthest-reaching box, otherwise use a
+// fresh symbol. z[0] is ignored, as in zToString.
+inline bool isZFunction(const std::vector<int>& z_function) {
+    const int size = z_function.size();
+    std::vector<int> symbols(size);
+    int fresh_symbol = 0;
+    int box_start = 0;
+    int box_end = 0;
+    for (int i = 0; i < size; ++i) {
+        int value = i ? z_function[i] : 0;
+        if (value < 0 || value > size - i) {
+            return false;
+        }
+        if (i + value > box_end) {
+            box_start = i;
+            box_end = i + value;
+        }
+        symbols[i] = i < box_end ? symbols[i - box_start] : fresh_symbol++;
+    }
+    std::vector<int> actual = prefixToZLinear(stringToPrefix(symbols));
+    for (int i = 1; i < size; ++i) {
+        if (actual[i] != z_function[i]) {
+            return false;
+        }
+    }
+    return true;
+}
+
+// Symbols are first_symbol + k for k < alphabet_size, so any arithmetic type works
+// (char for letters, integer token ids for large alphabets). An empty alphabet has no
+// strings, and the result is empty then.
+template <typename Symbol>
+std::vector<Symbol> zToSequence(const std::vector<int>& z_function, size_t alphabet_size,
+                                Symbol first_symbol = Symbol()) {
+    std::vector<Symbol> result;
+    if (!alphabet_size) {
+        return result;
+    }
+    result.reserve(z_function.size());
+    int j = 0;
+    int prefix_length = 0;
+    size_t available_symbol = 0;
+    for (size_t i = 0; i < z_function.size(); ++i) {
+        int z_value = i ? z_function[i] : 0;
+        if (!z_value && !prefix_length) {
+            result.push_back(first_symbol + available_symbol);
+
+            if (available_symbol + 1 < alphabet_size) {
+                ++available_symbol;
+            }
+        }
+        if (z_value > prefix_length) {
+            prefix_length = z_value;
+            j = 0;
+        }
+        if (prefix_length) {
+            result.push_back(result[j]);
+            ++j;
+            --prefix_length;
+        }
+    }
+    return result;
+}
+
+// The set of forbidden symbols is an epoch-stamped array: a symbol is forbidden
+// iff its stamp equals the current epoch, so starting a new set is O(1).
+template <typename Symbol>
+std::vector<Symbol> zToLexMinSequence(const std::vector<int>& z_function, size_t alphabet_size,
+                                      Symbol first_symbol = Symbol()) {
+    std::vector<Symbol> result;
+    if (!alphabet_size) {
+        return result;
+    }
+    result.reserve(z_function.size());
+    int j = 0;
+    int prefix_length = 0;
+    std::vector<int> prefix_z_values;
+    std::vector<unsigned> forbidden_epoch(alphabet_size, 0);
+    unsigned epoch = 0;
+    size_t available_symbol = 0;
+    for (size_t i = 0; i < z_function.size(); ++i) {
+        int z_value = i ? z_function[i] : 0;
+        if (!z_value && !prefix_length) {
+            if (j && available_symbol + 1 < alphabet_size) {
+                j = 0;
+                ++epoch;
+                for (int prefix_z_value : prefix_z_values) {
+                    forbidden_epoch[result[prefix_z_value] - first_symbol] = epoch;
+                }
+                for (size_t k = 1; k < alphabet_size; ++k) {
+                    if (forbidden_epoch[k] != epoch) {
+                        available_symbol = k;
+                        break;
+                    }
+                }
+            }
+            result.push_back(first_symbol + available_symbol);
+
+            available_symbol = alphabet_size > 1 ? 1 : 0;
+        }
+        if (z_value > prefix_length) {
+            prefix_length = z_value;
+            prefix_z_values.clear();
+            j = 0;
+        }
+        if (z_value == prefix_length && prefix_length) {
+            prefix_z_values.push_back(z_value);
+        }
+        if (prefix_length) {
+            result.push_back(result[j]);
+            ++j;
+            --prefix_length;
+        }
+    }
+    return result;
+}
+
+inline std::string zToString(const std::vector<int>& z_function) {
+    auto symbols = zToSequence<char>(z_function, 26, 'a');
+    return std::string(symbols.begin(), symbols.end());
+}
+
+inline std::string zToLexMinString(const std::vector<int>& z_function) {
+    auto symbols = zToLexMinSequence<char>(z_function, 26, 'a');
+    return std::string(symbols.begin(), symbols.end());
+}
+
+inline std::vector<int> stringToZ(std::string_view string) {
+    const int size = string.size();
+    std::vector<int> z_function(size, 0);
+    if (size == 0) {
+        return z_function;
+    }
+    z_function[0] = size;
+    int left = 0;
+    int right = 0;
+    for (int i = 1; i < size; ++i) {
+        int length = i < right ? std::min(z_function[i - left], right - i) : 0;
+        while (i + length < size && string[length] == string[i + length]) {
+            ++length;
+        }
+        if (i + length > right) {
+            left = i;
+            right = i + length;
+        }
+        z_function[i] = length;
+    }
+    return z_function;
+}
+
+// Z-function of pattern + separator + string without building the concatenation:
+// matches are capped by the pattern length, which is what the separator would do,
+// and the z-box over the string reuses the z-function of the pattern.
+inline std::vector<int> findOccurrencesZ(std::string_view string, std::string_view pattern) {
+    std::vector<int> occurrences;
+    const int size = string.size();
+    const int pattern_size = pattern.size();
+    if (pattern_size == 0 || pattern_size > size) {
+        return occurrences;
+    }
+    std::vector<int> pattern_z = stringToZ(pattern);
+    int left = 0;
+    int right = 0;
+    for (int i = 0; i < size; ++i) {
+        int length = i < right ? std::min(pattern_z[i - left], right - i) : 0;
+        while (length < pattern_size && i + length < size && pattern[length] == string[i + length]) {
+            ++length;
+        }
+        if (i + length > right) {
+            left = i;
+            right = i + length;
+        }
+        if (length == pattern_size) {
+            occurrences.push_back(i);
+        }
+    }
+    return occurrences;
+}
+
+inline std::vector<int> zToPrefix(const std::vector<int>& z) {
+    return zToPrefixLinear(z);
+}
+
+inline std::string prefixToString(const std::vector<int>& prefix) {
+    return zToString(prefixToZ(prefix));
+}
+
+inline std::string prefixToLexMinString(const std::vector<int>& prefix) {
+    return zToLexMinString(prefixToZ(prefix));
+}
@@ -1,138 +1,170 @@
 #include <iostream>
+#include <iomanip>
 #include <string>
+#include <string_view>
 #include <vector>
-
-std::vector<int> stringToPrefix(const std::string& string) {
-    std::vector<int> prefixFunction;
-    prefixFunction.push_back(0);
-    for (int i = 1; i < string.size(); ++i) {
-        int candidate = prefixFunction.back();
-        while (candidate > 0 && string[i] != string[candidate]) {
-            candidate = prefixFunction[candidate - 1];
-        }
-        if (string[i] == string[candidate]) {
-            ++candidate;
+#include <random>
+#include <chrono>
+#include <algorithm>
+#include "ZFunction.h"
+
+void benchmarkConversions() {
+    const size_t tries = 2000;
+    const size_t size = 1000;
+
+    std::mt19937_64 rd(std::chrono::system_clock::now().time_since_epoch().count());
+
+    std::vector<std::vector<int>> prefixes, zs;
+    for (size_t i = 0; i < tries; ++i) {
+        std::uniform_int_distribution<int> ds_char('a', 'a' + i % 3 + 1);
+        std::string string;
+        for (size_t j = 0; j < size; ++j) {
+            string.push_back((char)ds_char(rd));
         }
-        prefixFunction.push_back(candidate);
+        prefixes.push_back(stringToPrefix(string));
+        zs.push_back(prefixToZ(prefixes.back()));
+        zs.back()[0] = 0;
     }
-    return prefixFunction;
-}
 
-std::vector<int> prefixToZ(const std::vector<int>& prefix_function) {
-    std::vector<int> z_function(prefix_function.size(), 0);
-    z_function[0] = z_function.size();
-    for (int i = 1; i < prefix_function.size(); ++i) {
-        if (prefix_function[i]) {
-            z_function[i - prefix_function[i] + 1] = prefix_function[i];
+    long long checksum = 0;
+    auto measure = [&](auto convert, const std::vector<std::vector<int>>& inputs) {
+        auto time_start = std::chrono::steady_clock::now();
+        for (const auto& input : inputs) {
+            checksum += convert(input).back();
         }
-    }
-    for (int i = 1; i < z_function.size();) {
-        if (z_function[i] == 0) {
-            ++i;
-            continue;
+        auto time_end = std::chrono::steady_clock::now();
+        return (long long)(time_end - time_start).count();
+    };
+
+    long long prefix_to_z_old = measure([](const std::vector<int>& p) { return prefixToZ(p); }, prefixes);
+    long long prefix_to_z_new = measure([](const std::vector<int>& p) { return prefixToZLinear(p); }, prefixes);
+    long long z_to_prefix_old = measure([](const std::vector<int>& z) { return stringToPrefix(zToString(z)); }, zs);
+    long long z_to_prefix_new = measure([](const std::vector<int>& z) { return zToPrefixLinear(z); }, zs);
+
+    for (size_t i = 0; i < tries; ++i) {
+        if (prefixToZLinear(prefixes[i]) != prefixToZ(prefixes[i]) || zToPrefixLinear(zs[i]) != prefixes[i]) {
+            std::cout << "Mismatch on input " << i << '\n';
         }
-        int skip = 0;
-        for (int j = 1; j < z_function[i]; ++j) {
-            if (z_function[j] < z_function[i + j]) {
-                break;
-            }
-            z_function[i + j] = std::min(z_function[j], z_function[i] - j);
-            skip = j;
-        }
-        i += skip + 1;
     }
-    return z_function;
+
+    auto arrays_per_second = [&](long long time) {
+        return time ? (long long)(tries * 1e9 / time) : 0;
+    };
+
+    std::cout << std::setw(28) << std::left << "Conversion"         << std::setw(14) << "Overall, ns"   << "Arrays/s"                           << '\n';
+    std::cout << std::setw(28) << std::left << "prefixToZ"          << std::setw(14) << prefix_to_z_old << arrays_per_second(prefix_to_z_old) << '\n';
+    std::cout << std::setw(28) << std::left << "prefixToZLinear"    << std::setw(14) << prefix_to_z_new << arrays_per_second(prefix_to_z_new) << '\n';
+    std::cout << std::setw(28) << std::left << "stringToPrefix(zToString)" << std::setw(14) << z_to_prefix_old << arrays_per_second(z_to_prefix_old) << '\n';
+    std::cout << std::setw(28) << std::left << "zToPrefixLinear"    << std::setw(14) << z_to_prefix_new << arrays_per_second(z_to_prefix_new) << '\n';
+    std::cout << "(checksum " << checksum << ")\n";
 }
 
-std::string zToString(const std::vector<int>& z_function) {
-    std::string result;
-    int j = 0;
-    int prefix_length = 0;
-    char alphabet_size = 26;
-    char available_char = 0;
-    for (int i = 0; i < z_function.size(); ++i) {
-        int z_value = i ? z_function[i] : 0;
-        if (!z_value && !prefix_length) {
-            result.push_back('a' + available_char);
-
-            if (available_char < alphabet_size - 1) {
-                ++available_char;
+void benchmarkSearch() {
+    struct Profile {
+        std::string name;
+        char alphabet_size;
+        size_t pattern_size;
+        bool periodic;
+    };
+    const std::vector<Profile> profiles = {
+        {"binary, short pattern", 2, 8, false},
+        {"binary, long pattern", 2, 1000, false},
+        {"letters, short pattern", 26, 8, false},
+        {"letters, long pattern", 26, 1000, false},
+        {"periodic, short pattern", 1, 8, true},
+        {"periodic, long pattern", 1, 1000, true},
+    };
+    const size_t tries = 10;
+    const size_t size = 1000000;
+
+    std::mt19937_64 rd(std::chrono::system_clock::now().time_since_epoch().count());
+
+    std::cout << std::setw(28) << std::left << "Profile" << std::setw(14) << "KMP, ns" << std::setw(14) << "Z, ns" << "Faster" << '\n';
+    for (const auto& profile : profiles) {
+        std::uniform_int_distribution<int> ds_char('a', 'a' + profile.alphabet_size - 1);
+        long long kmp_time = 0, z_time = 0;
+        for (size_t i = 0; i < tries; ++i) {
+            std::string string;
+            for (size_t j = 0; j < size; ++j) {
+                string.push_back((char)ds_char(rd));
+            }
+            std::string pattern = string.substr(size / 2, profile.pattern_size);
+            if (profile.periodic) {
+                pattern.back() = 'b';       //forces long partial matches that fail at the end
+            }
+
+            auto time_start = std::chrono::steady_clock::now();
+            auto kmp_occurrences = findOccurrences(string, pattern);
+            auto time_end = std::chrono::steady_clock::now();
+            kmp_time += (time_end - time_start).count();
+
+            time_start = std::chrono::steady_clock::now();
+            auto z_occurrences = findOccurrencesZ(string, pattern);
+            time_end = std::chrono::steady_clock::now();
+            z_time += (time_end - time_start).count();
+
+            if (kmp_occurrences != z_occurrences) {
+                std::cout << "Mismatch on profile " << profile.name << '\n';
             }
         }
-        if (z_value > prefix_length) {
-            prefix_length = z_value;
-            j = 0;
-        }
-        if (prefix_length) {
-            result += result[j];
-            ++j;
-            --prefix_length;
-        }
+        std::cout << std::setw(28) << std::left << profile.name << std::setw(14) << kmp_time / tries
+                  << std::setw(14) << z_time / tries << (kmp_time <= z_time ? "KMP" : "Z") << '\n';
     }
-    return result;
 }
 
-std::string zToLexMinString(const std::vector<int>& z_function) {
-    std::string result;
-    int j = 0;
-    int prefix_length = 0;
-    std::vector<int> prefix_z_values;
-    char alphabet_size = 26;
-    char available_char = 0;
-    for (int i = 0; i < z_function.size(); ++i) {
-        int z_value = i ? z_function[i] : 0;
-        if (!z_value && !prefix_length) {
-            if (j && available_char < alphabet_size - 1) {
-                j = 0;
-                std::vector<int> alphabet_mask(alphabet_size, 0);
-                for (int prefix_z_value : prefix_z_values) {
-                    alphabet_mask[result[prefix_z_value] - 'a'] = 1;
-                }
-                for (char k = 1; k < alphabet_size; ++k) {
-                    if (!alphabet_mask[k]) {
-                        available_char = k;
-                        break;
-                    }
-                }
+// Restores strings from z-functions with alphabets from one letter up and checks that
+// every symbol is inside the alphabet and that an alphabet as large as the original
+// string's gives back the same z-function; both validators must accept the arrays of
+// every string, the empty one too. Returns the number of mismatches.
+size_t checkZToSequence(size_t tries) {
+    const size_t size = 12;
+    std::mt19937_64 rd(0);
+
+    size_t mismatches = 0;
+    auto check = [&](const std::vector<int>& z, size_t alphabet_size, bool exact) {
+        for (const auto& symbols : {zToSequence<int>(z, alphabet_size), zToLexMinSequence<int>(z, alphabet_size)}) {
+            for (int symbol : symbols) {
+                mismatches += symbol < 0 || symbol >= (int)alphabet_size;
             }
-            result.push_back('a' + available_char);
-
-            available_char = 1;
+            std::string string(symbols.begin(), symbols.end());
+            std::vector<int> restored = stringToZ(string);
+            mismatches += exact && !std::equal(z.begin() + 1, z.end(), restored.begin() + 1);
         }
-        if (z_value > prefix_length) {
-            prefix_length = z_value;
-            prefix_z_values.clear();
-            j = 0;
+    };
+    check({0, 0, 0}, 1, false);
+    mismatches += !isPrefixFunction({}) || !isZFunction({});
+    for (size_t i = 0; i < tries; ++i) {
+        size_t letters = 1 + i % 4;
+        std::uniform_int_distribution<int> ds_char('a', 'a' + letters - 1);
+        std::string string;
+        for (size_t j = 0; j < size; ++j) {
+            string.push_back((char)ds_char(rd));
         }
-        if (z_value == prefix_length && prefix_length) {
-            prefix_z_values.push_back(z_value);
-        }
-        if (prefix_length) {
-            result += result[j];
-            ++j;
-            --prefix_length;
+        std::vector<int> z = stringToZ(string);
+        for (size_t alphabet_size = 1; alphabet_size <= 5; ++alphabet_size) {
+            check(z, alphabet_size, false);
         }
+        check(z, size, true);
+        mismatches += !isZFunction(z) || !isPrefixFunction(stringToPrefix(string));
     }
-    return result;
-}
-
-std::vector<int> stringToZ(const std::string& string) {
-    return prefixToZ(stringToPrefix(string));
-}
-
-std::vector<int> zToPrefix(const std::vector<int>& z) {
-    return stringToPrefix(zToString(z));
+    return mismatches;
 }
 
-std::string prefixToString(const std::vector<int>& prefix) {
-    return zToString(prefixToZ(prefix));
-}
-
-std::string prefixToLexMinString(const std::vector<int>& prefix) {
-    return zToLexMinString(prefixToZ(prefix));
-}
+int main(int argc, char** argv) {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        benchmarkConversions();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-search") {
+        benchmarkSearch();
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        size_t mismatches = checkZToSequence(argc > 2 ? std::stoull(argv[2]) : 10000);
+        std::cout << mismatches << " mismatches" << '\n';
+        return mismatches != 0;
+    }
 
-int main() {
     std::string qwe = "acbacbbababcbababc";//"abcbabaabbbcccccabcabc";
     std::cout << qwe << '\n';
 
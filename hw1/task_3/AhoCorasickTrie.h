@@ -0,0 +1,122 @@
+#pragma once
+
+#include <vector>
+#include <string>
+
+class AhoCorasickTrie {
+private:
+    struct Node {
+        std::vector<int> children = std::vector<int>(1 << (sizeof(char) * 8 - 1), 0);
+        int parent = -1;
+        char char_from_parent = 0;
+        bool terminal = false;
+        std::vector<int> terminal_pattern_ids;
+        int failure_link = -1;
+        int output_link = -1;
+    };
+
+    std::vector<Node> trie;
+
+    int current_traversal_node = 0;
+
+public:
+    AhoCorasickTrie();
+
+    void addPatternToTrie(const std::string &pattern, int pattern_id);
+
+    int getNextNode(int node_id, char c);
+
+    int getFailureLink(int node_id);
+
+    int getOutputLink(int node_id);
+
+    std::vector<int> traverseLetter(char letter);
+
+    void resetTraversal();
+
+};
+
+
+inline AhoCorasickTrie::AhoCorasickTrie() {
+    trie.emplace_back();
+}
+
+inline void AhoCorasickTrie::addPatternToTrie(const std::string &pattern, int pattern_id) {
+    int current = 0;
+    for (int i = 0; i < pattern.size(); ++i) {
+        char c = pattern[i] - 'a';
+        if (!trie[current].children[c]) {
+            trie.emplace_back();
+            trie.back().parent = current;
+            trie.back().char_from_parent = c;
+            trie[current].children[c] = trie.size() - 1;
+        }
+        current = trie[current].children[c];
+        if (i == pattern.size() - 1) {
+            trie[current].terminal = true;
+            trie[current].terminal_pattern_ids.push_back(pattern_id);
+        }
+    }
+}
+
+
+inline int AhoCorasickTrie::getNextNode(int node_id, char c) {
+    if (trie[node_id].children[c]) {
+        return trie[node_id].children[c];
+    } else if (node_id == 0) {
+        return 0;
+    } else {
+        return getNextNode(getFailureLink(node_id), c);
+    }
+}
+
+inline int AhoCorasickTrie::getFailureLink(int node_id) {
+    Node &node = trie[node_id];
+    if (node.failure_link == -1) {
+        if (node.parent <= 0) {
+            node.failure_link = 0;
+        } else {
+            node.failure_link = getNextNode(getFailureLink(node.parent),
+                                            node.char_from_parent);
+        }
+    }
+    return node.failure_link;
+}
+
+inline int AhoCorasickTrie::getOutputLink(int node_id) {
+    Node &node = trie[node_id];
+    if (node.output_link == -1) {
+        int failure_link = getFailureLink(node_id);
+        if (trie[failure_link].parent == -1) {
+            node.output_link = 0;
+        } else if (trie[failure_link].terminal) {
+            node.output_link = failure_link;
+        } else {
+            node.output_link = getOutputLink(failure_link);
+        }
+    }
+    return node.output_link;
+}
+
+inline std::vector<int> AhoCorasickTrie::traverseLetter(char letter) {
+    current_traversal_node = getNextNode(current_traversal_node, letter - 'a');
+
+    int current_output_node = current_traversal_node;
+    if (!trie[current_output_node].terminal) {
+        current_output_node = getOutputLink(current_output_node);
+    }
+
+    std::vector<int> output;
+    while (current_output_node) {
+        for (auto id : trie[current_output_node].terminal_pattern_ids) {
+            output.push_back(id);
+        }
+        current_output_node = getOutputLink(current_output_node);
+    }
+
+    return output;
+}
+
+inline void AhoCorasickTrie::resetTraversal() {
+    current_traversal_node = 0;
+}
@@ -0,0 +1,129 @@
+#pragma once
+
+#include <vector>
+#include <map>
+
+class OnlineSubstringCounter {
+private:
+    struct State {
+        size_t length = 0;
+        size_t link = 0;
+        bool has_link = false;
+        std::map<char, size_t> next;
+    };
+
+    size_t max_length = 0;
+    size_t length = 0;
+    size_t last = 0;
+    size_t count = 0;
+    std::vector<State> states;
+
+public:
+    struct Snapshot {
+        size_t length;
+        size_t last;
+        size_t count;
+        std::vector<State> states;
+    };
+
+    explicit OnlineSubstringCounter(size_t max_length);
+
+    bool append(char c);                   //false if max_length characters were already appended
+
+    size_t differentSubstrings() const;
+    size_t size() const;
+
+    Snapshot snapshot() const;
+    //false, and nothing changes, if the snapshot is longer than max_length
+    bool restore(const Snapshot& snapshot);
+    bool restore(Snapshot&& snapshot);
+};
+
+
+inline OnlineSubstringCounter::OnlineSubstringCounter(size_t max_length) : max_length(max_length) {
+    states.reserve(2 * max_length + 1);    //suffix automaton never has more than 2n - 1 states
+    states.emplace_back();
+}
+
+inline bool OnlineSubstringCounter::append(char c) {
+    if (length == max_length) {
+        return false;
+    }
+    ++length;
+    size_t current = states.size();
+    states.emplace_back();
+    states[current].length = states[last].length + 1;
+
+    size_t p = last;
+    bool found = true;
+    while (!states[p].next.count(c)) {
+        states[p].next[c] = current;
+        if (!states[p].has_link) {
+            found = false;
+            break;
+        }
+        p = states[p].link;
+    }
+
+    if (found) {
+        size_t q = states[p].next[c];
+        if (states[p].length + 1 == states[q].length) {
+            states[current].link = q;
+        }
+        else {
+            size_t clone = states.size();
+            states.push_back(states[q]);
+            states[clone].length = states[p].length + 1;
+            while (true) {
+                auto it = states[p].next.find(c);
+                if (it == states[p].next.end() || it->second != q) {
+                    break;
+                }
+                it->second = clone;
+                if (!states[p].has_link) {
+                    break;
+                }
+                p = states[p].link;
+            }
+            states[q].link = clone;
+            states[current].link = clone;
+        }
+    }
+    states[current].has_link = true;
+    last = current;
+
+    //every new substring is a suffix of the new string that was not seen before
+    count += states[current].length - states[states[current].link].length;
+    return true;
+}
+
+inline size_t OnlineSubstringCounter::differentSubstrings() const {
+    return count;
+}
+
+inline size_t OnlineSubstringCounter::size() const {
+    return length;
+}
+
+inline OnlineSubstringCounter::Snapshot OnlineSubstringCounter::snapshot() const {
+    return Snapshot{length, last, count, states};
+}
+
+inline bool OnlineSubstringCounter::restore(const Snapshot& snapshot) {
+    if (snapshot.length > max_length) {
+        return false;
+    }
+    return restore(Snapshot(snapshot));
+}
+
+inline bool OnlineSubstringCounter::restore(Snapshot&& snapshot) {
+    if (snapshot.length > max_length) {
+        return false;
+    }
+    length = snapshot.length;
+    last = snapshot.last;
+    count = snapshot.count;
+    states = std::move(snapshot.states);
+    states.reserve(2 * max_length + 1);
+    return true;
+}
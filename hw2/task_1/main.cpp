@@ -1,157 +1,86 @@
 #include <iostream>
 #include <vector>
 #include <string>
+#include <set>
+#include <random>
+#include "SuffixArrayWithLCP.h"
+#include "OnlineSubstringCounter.h"
 
-using std::vector;
-
-class SuffixArrayWithLCP {
-private:
-    static const size_t ALPHABET_SIZE = 255;  //maximum ascii value of a character in used strings
-    std::string string;
-    vector<size_t> suffix_array;
-    vector<size_t> lcp_array;
-
-    struct RankedSuffix {
-        size_t index;
-        int rank;
-        int rank_next;
-    };
-
-    void constructSuffix();
-    void constructLCP();
-
-public:
-    SuffixArrayWithLCP() = default;
-    explicit SuffixArrayWithLCP(std::string input);
-
-    size_t operator[](size_t pos) const;
-    size_t lcp(size_t pos) const;
-};
-
-
-const size_t SuffixArrayWithLCP::ALPHABET_SIZE;
-
-void SuffixArrayWithLCP::constructSuffix() {
-    const size_t size = string.size();
-    vector<RankedSuffix> suffixes(size);
-    for (size_t i = 0; i < size; ++i) {
-        suffixes[i].index = i;
+size_t countDifferentSubstrings(const std::string &string) {
+    SuffixArrayWithLCP suf(string);
+    size_t ans = 0;
+    for (size_t i = 0; i < string.size(); ++i) {
+        ans += string.size() - suf[i];
+        ans -= suf.lcp(i);
     }
-    for (size_t cycle_size = 2; cycle_size < 2 * size; cycle_size <<= 1) {
-        if (cycle_size == 2) {
-            for (size_t i = 0; i < size; ++i) {
-                suffixes[i].rank = string[i];
-                suffixes[i].rank_next = i + 1 < size ? string[i + 1] : -1;
-            }
-        }
-        else {
-            int prev_rank = 0;
-            vector<size_t> index_to_suffix(size);
-            for (size_t i = 0; i < size; ++i) {
-                if (i == 0) {
-                    prev_rank = suffixes[i].rank;
-                    suffixes[i].rank = 0;
-                }
-                else {
-                    if (suffixes[i].rank == prev_rank &&
-                        suffixes[i].rank_next == suffixes[i - 1].rank_next)
-                    {
-                        suffixes[i].rank = suffixes[i - 1].rank;
-                    }
-                    else {
-                        prev_rank = suffixes[i].rank;
-                        suffixes[i].rank = suffixes[i - 1].rank + 1;
-                    }
-                    index_to_suffix[suffixes[i].index] = i;
-                }
-            }
-            for (size_t i = 0; i < size; ++i) {
-                size_t next_index = suffixes[i].index + cycle_size / 2;
-                suffixes[i].rank_next = next_index < size
-                                        ? suffixes[index_to_suffix[next_index]].rank
-                                        : -1;
-            }
-        }
-
-        for (int rank_type = 0; rank_type < 2; ++rank_type) {
-            vector<RankedSuffix> buffer(size);
-            vector<size_t> counter(std::max<size_t>(size + 1, ALPHABET_SIZE));
-            for (int i = 0; i < size; ++i) {
-                int value = rank_type ? suffixes[i].rank : suffixes[i].rank_next;
-                ++counter[value + 1];
-            }
-            for (int i = 1; i < counter.size(); ++i) {
-                counter[i] += counter[i - 1];
-            }
-            for (size_t i = size; i > 0; --i) {
-                int value = rank_type ? suffixes[i - 1].rank : suffixes[i - 1].rank_next;
-                buffer[counter[value + 1] - 1] = suffixes[i - 1];
-                counter[value + 1]--;
-            }
-            for (size_t i = 0; i < size; i++) {
-                suffixes[i] = buffer[i];
-            }
-        }
+    return ans;
+}
 
-        suffix_array.resize(size);
-        for (int i = 0; i < size; ++i) {
-            suffix_array[i] = suffixes[i].index;
+size_t countDifferentSubstringsNaive(const std::string &string) {
+    std::set<std::string> substrings;
+    for (size_t i = 0; i < string.size(); ++i) {
+        for (size_t j = i + 1; j <= string.size(); ++j) {
+            substrings.insert(string.substr(i, j - i));
         }
     }
+    return substrings.size();
 }
 
-void SuffixArrayWithLCP::constructLCP() {
-    const size_t size = suffix_array.size();
-    lcp_array.resize(size);
-    vector<size_t> index_to_suffix(size);
-    for (size_t i = 0; i < size; ++i) {
-        index_to_suffix[suffix_array[i]] = i;
-    }
-    size_t prev_lcp = 0;
-    for (int current = 0; current < size; ++current) {
-        if (index_to_suffix[current] == size - 1) {
-            prev_lcp = 0;
+// Appends random characters to OnlineSubstringCounter and compares the count after every
+// one with the set of all substrings. Halfway a snapshot is taken; more characters are
+// appended, the snapshot is restored and the counter must go on from the shorter string
+// as if nothing was appended after it. A counter with a smaller max_length must refuse a
+// snapshot that is too long for it. Returns the number of mismatches.
+size_t checkOnlineCounter(size_t tries) {
+    const size_t max_size = 40;
+    std::mt19937_64 rd(0);
+
+    size_t mismatches = 0;
+    for (size_t i = 0; i < tries; ++i) {
+        std::uniform_int_distribution<int> ds_char('a', 'a' + i % 4);
+        std::string string;
+        OnlineSubstringCounter counter(max_size);
+        auto append = [&]() {
+            char c = (char)ds_char(rd);
+            string.push_back(c);
+            counter.append(c);
+            mismatches += counter.size() != string.size()
+                          || counter.differentSubstrings() != countDifferentSubstringsNaive(string);
+        };
+
+        size_t snapshot_size = rd() % (max_size / 2);
+        while (string.size() < snapshot_size) {
+            append();
         }
-        else {
-            if (prev_lcp > 0) {
-                --prev_lcp;
-            }
-            size_t next = suffix_array[index_to_suffix[current] + 1];
-            while (current + prev_lcp < size
-                   && next + prev_lcp < size
-                   && string[current + prev_lcp] == string[next + prev_lcp]) {
-                ++prev_lcp;
-            }
+        auto snapshot = counter.snapshot();
+        std::string snapshot_string = string;
+        size_t appended_size = snapshot_size + rd() % (max_size / 2);
+        while (string.size() < appended_size) {
+            append();
         }
-        lcp_array[index_to_suffix[current]] = prev_lcp;
-    }
-}
-
-SuffixArrayWithLCP::SuffixArrayWithLCP(std::string input) : string(std::move(input)) {
-    constructSuffix();
-    constructLCP();
-}
-
-inline size_t SuffixArrayWithLCP::operator[](size_t pos) const {
-    return suffix_array[pos];
-}
+        mismatches += !counter.restore(snapshot);
+        string = snapshot_string;
+        mismatches += counter.size() != string.size()
+                      || counter.differentSubstrings() != countDifferentSubstringsNaive(string);
+        while (string.size() < max_size) {
+            append();
+        }
+        mismatches += counter.append('a') || counter.differentSubstrings() != countDifferentSubstrings(string);
 
-inline size_t SuffixArrayWithLCP::lcp(size_t pos) const {
-    return lcp_array[pos];
+        //a snapshot of a longer counter doesn't fit and must leave this one as it is
+        OnlineSubstringCounter shorter(max_size - 1);
+        mismatches += shorter.restore(counter.snapshot()) || shorter.size() != 0;
+    }
+    return mismatches;
 }
 
-
-size_t countDifferentSubstrings(const std::string &string) {
-    SuffixArrayWithLCP suf(string);
-    size_t ans = 0;
-    for (size_t i = 0; i < string.size(); ++i) {
-        ans += string.size() - suf[i];
-        ans -= suf.lcp(i);
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        size_t mismatches = checkOnlineCounter(argc > 2 ? std::stoull(argv[2]) : 1000);
+        std::cout << mismatches << " mismatches" << '\n';
+        return mismatches != 0;
     }
-    return ans;
-}
 
-int main() {
     std::string string;
     std::cin >> string;
     std::cout << countDifferentSubstrings(string);
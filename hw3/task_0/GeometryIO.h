@@ -0,0 +1,219 @@
+#pragma once
+
+#include <cstdio>
+#include <cstring>
+#include <cstdint>
+#include <charconv>
+#include <string>
+#include <vector>
+#include <type_traits>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+// Text input parsed with std::from_chars over the whole stream read in one go.
+class FastInput {
+private:
+    std::vector<char> buffer;
+    const char *position = nullptr;
+    const char *end = nullptr;
+
+    void skipSpaces() {
+        while (position != end && (*position == ' ' || *position == '\n' || *position == '\r' || *position == '\t')) {
+            ++position;
+        }
+    }
+
+public:
+    explicit FastInput(FILE *file = stdin) {
+        const size_t chunk = 1 << 16;
+        size_t size = 0;
+        while (true) {
+            buffer.resize(size + chunk);
+            size_t count = fread(buffer.data() + size, 1, chunk, file);
+            size += count;
+            if (count < chunk) {
+                break;
+            }
+        }
+        buffer.resize(size);
+        position = buffer.data();
+        end = buffer.data() + size;
+    }
+
+    template <typename Number>
+    bool read(Number &value) {
+        skipSpaces();
+        if (position != end && *position == '+') {
+            ++position;
+        }
+        auto result = std::from_chars(position, end, value);
+        if (result.ec != std::errc()) {
+            return false;
+        }
+        position = result.ptr;
+        return true;
+    }
+};
+
+// Text output formatted with std::to_chars into a buffer flushed in large blocks.
+class FastOutput {
+private:
+    FILE *file;
+    std::vector<char> buffer;
+    size_t size = 0;
+
+    void reserve(size_t count) {
+        if (size + count > buffer.size()) {
+            flush();
+        }
+    }
+
+public:
+    explicit FastOutput(FILE *file = stdout) : file(file), buffer(1 << 16) {}
+
+    ~FastOutput() {
+        flush();
+    }
+
+    void flush() {
+        fwrite(buffer.data(), 1, size, file);
+        size = 0;
+    }
+
+    //chars_format::general with precision 6 matches the default std::ostream formatting
+    void write(double value, std::chars_format format = std::chars_format::general, int precision = 6) {
+        reserve(64);
+        auto result = std::to_chars(buffer.data() + size, buffer.data() + buffer.size(), value, format, precision);
+        size = result.ptr - buffer.data();
+    }
+
+    void write(char c) {
+        reserve(1);
+        buffer[size++] = c;
+    }
+
+    void write(const char *string) {
+        size_t length = strlen(string);
+        if (length > buffer.size()) {
+            flush();
+            fwrite(string, 1, length, file);
+            return;
+        }
+        reserve(length);
+        memcpy(buffer.data() + size, string, length);
+        size += length;
+    }
+};
+
+
+// Raw binary arrays of plain records (Vector2D, Vector3D, segments): an 8-byte tag,
+// the record count as a little-endian uint64 and the records themselves, so a
+// mapped file can be used as an array in place without parsing.
+
+#if !defined(__BYTE_ORDER__) || __BYTE_ORDER__ != __ORDER_LITTLE_ENDIAN__
+#error "binary geometry files are little-endian and are mapped without conversion"
+#endif
+
+struct BinaryArrayHeader {
+    char tag[8];
+    uint64_t count;
+};
+
+template <typename Record>
+bool writeBinaryArray(const std::string &path, const char *tag, const Record *records, size_t count) {
+    static_assert(std::is_trivially_copyable<Record>::value, "records are written as raw bytes");
+    FILE *file = fopen(path.c_str(), "wb");
+    if (!file) {
+        return false;
+    }
+    BinaryArrayHeader header = {};
+    strncpy(header.tag, tag, sizeof(header.tag));
+    header.count = count;
+    bool success = fwrite(&header, sizeof(header), 1, file) == 1
+                   && fwrite(records, sizeof(Record), count, file) == count;
+    return fclose(file) == 0 && success;
+}
+
+template <typename Record>
+bool writeBinaryArray(const std::string &path, const char *tag, const std::vector<Record> &records) {
+    return writeBinaryArray(path, tag, records.data(), records.size());
+}
+
+// Read-only memory mapping of a file written by writeBinaryArray.
+template <typename Record>
+class MappedArray {
+private:
+    void *mapping = MAP_FAILED;
+    size_t mapping_size = 0;
+    const Record *records = nullptr;
+    size_t count = 0;
+
+    void close() {
+        if (mapping != MAP_FAILED) {
+            munmap(mapping, mapping_size);
+        }
+        mapping = MAP_FAILED;
+        records = nullptr;
+        count = 0;
+    }
+
+public:
+    static_assert(std::is_trivially_copyable<Record>::value, "records are read as raw bytes");
+
+    MappedArray() = default;
+    MappedArray(const MappedArray &) = delete;
+    MappedArray &operator=(const MappedArray &) = delete;
+
+    ~MappedArray() {
+        close();
+    }
+
+    // False if the file can't be mapped, has another tag or is truncated.
+    bool open(const std::string &path, const char *tag) {
+        close();
+        int descriptor = ::open(path.c_str(), O_RDONLY);
+        if (descriptor < 0) {
+            return false;
+        }
+        struct stat status;
+        if (fstat(descriptor, &status) == 0 && (size_t)status.st_size >= sizeof(BinaryArrayHeader)) {
+            mapping_size = status.st_size;
+            mapping = mmap(nullptr, mapping_size, PROT_READ, MAP_PRIVATE, descriptor, 0);
+        }
+        ::close(descriptor);
+        if (mapping == MAP_FAILED) {
+            return false;
+        }
+        const auto *header = static_cast<const BinaryArrayHeader *>(mapping);
+        if (strncmp(header->tag, tag, sizeof(header->tag)) != 0
+            || header->count > (mapping_size - sizeof(BinaryArrayHeader)) / sizeof(Record)) {
+            close();
+            return false;
+        }
+        records = reinterpret_cast<const Record *>(static_cast<const char *>(mapping) + sizeof(BinaryArrayHeader));
+        count = header->count;
+        return true;
+    }
+
+    const Record *data() const {
+        return records;
+    }
+
+    size_t size() const {
+        return count;
+    }
+
+    const Record &operator[](size_t i) const {
+        return records[i];
+    }
+
+    const Record *begin() const {
+        return records;
+    }
+
+    const Record *end() const {
+        return records + count;
+    }
+};
@@ -0,0 +1,153 @@
+#pragma once
+
+#include <cmath>
+#include <cstdint>
+#include <limits>
+#include <type_traits>
+#include "Primitives2D.h"
+
+// Sign of (p1 - p0) x (q1 - q0), i.e. of the z component of the cross product of two
+// edge vectors given by their endpoints. orientation(a, b, c) is the usual turn test:
+// positive for a counter-clockwise turn a -> b -> c.
+//
+// For double (and float, widened to it) the determinant is first evaluated in plain
+// floating point; only if it is within the forward error bound of zero it is recomputed
+// exactly with floating point expansions (Shewchuk, "Adaptive Precision Floating-Point
+// Arithmetic and Fast Robust Geometric Predicates"). For 64-bit integers the products are
+// compared in 128 bits, other component types (exact rationals) are trusted to compute
+// exactly; other floating point types don't compile.
+
+namespace predicates_detail {
+
+// a + b = sum + error exactly
+inline void twoSum(double a, double b, double &sum, double &error) {
+    sum = a + b;
+    double b_virtual = sum - a;
+    double a_virtual = sum - b_virtual;
+    error = (a - a_virtual) + (b - b_virtual);
+}
+
+// a * b = product + error exactly
+inline void twoProduct(double a, double b, double &product, double &error) {
+    product = a * b;
+    error = std::fma(a, b, -product);
+}
+
+// Nonoverlapping expansion with components in increasing magnitude, zeroes removed.
+struct Expansion {
+    double components[16];
+    int size = 0;
+
+    void grow(double value) {
+        int new_size = 0;
+        double carry = value;
+        for (int i = 0; i < size; ++i) {
+            double sum, error;
+            twoSum(carry, components[i], sum, error);
+            carry = sum;
+            if (error != 0) {
+                components[new_size++] = error;
+            }
+        }
+        if (carry != 0) {
+            components[new_size++] = carry;
+        }
+        size = new_size;
+    }
+
+    int sign() const {
+        return size == 0 ? 0 : (components[size - 1] > 0 ? 1 : -1);
+    }
+};
+
+inline int exactCrossSign(double p0x, double p0y, double p1x, double p1y,
+                   double q0x, double q0y, double q1x, double q1y) {
+    //every difference is exactly hi + lo
+    double a[2][2], b[2][2];      //a = p1 - p0, b = q1 - q0; [coordinate][hi, lo]
+    twoSum(p1x, -p0x, a[0][0], a[0][1]);
+    twoSum(p1y, -p0y, a[1][0], a[1][1]);
+    twoSum(q1x, -q0x, b[0][0], b[0][1]);
+    twoSum(q1y, -q0y, b[1][0], b[1][1]);
+
+    Expansion determinant;
+    for (int i = 0; i < 2; ++i) {
+        for (int j = 0; j < 2; ++j) {
+            double product, error;
+            twoProduct(a[0][i], b[1][j], product, error);
+            determinant.grow(error);
+            determinant.grow(product);
+            twoProduct(-a[1][i], b[0][j], product, error);
+            determinant.grow(error);
+            determinant.grow(product);
+        }
+    }
+    return determinant.sign();
+}
+
+}
+
+template <typename ComponentType>
+int crossSign(const BasicPoint2D<ComponentType> &p0, const BasicPoint2D<ComponentType> &p1,
+              const BasicPoint2D<ComponentType> &q0, const BasicPoint2D<ComponentType> &q1) {
+    static_assert(!std::is_floating_point<ComponentType>::value,
+                  "floating point coordinates need the adaptive overload for double");
+    ComponentType determinant = (p1.x() - p0.x()) * (q1.y() - q0.y()) - (p1.y() - p0.y()) * (q1.x() - q0.x());
+    return (determinant > ComponentType(0)) - (determinant < ComponentType(0));
+}
+
+// A difference of 64-bit coordinates takes 65 bits and a product of two of them 129, so
+// the two products are compared by sign and unsigned 128-bit magnitude, not subtracted.
+inline int crossSign(const BasicPoint2D<int64_t> &p0, const BasicPoint2D<int64_t> &p1,
+                     const BasicPoint2D<int64_t> &q0, const BasicPoint2D<int64_t> &q1) {
+    auto product = [](int64_t a0, int64_t a1, int64_t b0, int64_t b1, unsigned __int128 &magnitude) {
+        __int128 a = (__int128)a1 - a0, b = (__int128)b1 - b0;
+        magnitude = (unsigned __int128)(a < 0 ? -a : a) * (unsigned __int128)(b < 0 ? -b : b);
+        return magnitude ? ((a < 0) != (b < 0) ? -1 : 1) : 0;
+    };
+    unsigned __int128 left, right;
+    int left_sign = product(p0.x(), p1.x(), q0.y(), q1.y(), left);
+    int right_sign = product(p0.y(), p1.y(), q0.x(), q1.x(), right);
+    if (left_sign != right_sign) {
+        return left_sign > right_sign ? 1 : -1;
+    }
+    return left_sign * ((left > right) - (left < right));
+}
+
+// Filter stage of crossSign for edge vectors a = p1 - p0 and b = q1 - q0 that were
+// already computed in double. Returns false if the sign can't be trusted and crossSign
+// has to be called on the endpoints.
+inline bool filteredCrossSign(const BasicVector2D<double> &a, const BasicVector2D<double> &b, int &sign) {
+    const double epsilon = std::numeric_limits<double>::epsilon() / 2;
+    const double error_bound = (3 + 16 * epsilon) * epsilon;
+
+    double left = a.x() * b.y();
+    double right = a.y() * b.x();
+    double determinant = left - right;
+    sign = (determinant > 0) - (determinant < 0);
+    return std::fabs(determinant) > error_bound * (std::fabs(left) + std::fabs(right));
+}
+
+inline int crossSign(const BasicPoint2D<double> &p0, const BasicPoint2D<double> &p1,
+                     const BasicPoint2D<double> &q0, const BasicPoint2D<double> &q1) {
+    int sign;
+    if (filteredCrossSign(BasicVector2D<double>(p1, p0), BasicVector2D<double>(q1, q0), sign)) {
+        return sign;
+    }
+    return predicates_detail::exactCrossSign(p0.x(), p0.y(), p1.x(), p1.y(),
+                                             q0.x(), q0.y(), q1.x(), q1.y());
+}
+
+// A float converts to double exactly, and the double path is exact for any coordinates.
+inline int crossSign(const BasicPoint2D<float> &p0, const BasicPoint2D<float> &p1,
+                     const BasicPoint2D<float> &q0, const BasicPoint2D<float> &q1) {
+    auto widen = [](const BasicPoint2D<float> &point) {
+        return BasicPoint2D<double>(point.x(), point.y());
+    };
+    return crossSign(widen(p0), widen(p1), widen(q0), widen(q1));
+}
+
+template <typename ComponentType>
+int orientation(const BasicPoint2D<ComponentType> &a, const BasicPoint2D<ComponentType> &b,
+                const BasicPoint2D<ComponentType> &c) {
+    return crossSign(a, b, a, c);
+}
@@ -1,37 +1,122 @@
 #pragma once
 
-class Point2D {
+#include <utility>
+
+template <typename ComponentType>
+class BasicPoint2D {
 public:
-    typedef double componentType;
+    typedef ComponentType componentType;
 
 protected:
     componentType x_, y_;
 
 public:
-    explicit Point2D(componentType x = 0, componentType y = 0);
-    bool operator==(const Point2D& other) const;
-    const componentType& x() const;
-    const componentType& x(componentType x);
-    const componentType& y() const;
-    const componentType& y(componentType y);
+    constexpr explicit BasicPoint2D(componentType x = componentType(), componentType y = componentType())
+            : x_(std::move(x)), y_(std::move(y)) {}
+
+    constexpr bool operator==(const BasicPoint2D& other) const {
+        return x_ == other.x_ && y_ == other.y_;
+    }
+
+    constexpr const componentType& x() const {
+        return x_;
+    }
+
+    constexpr const componentType& x(componentType x) {
+        x_ = std::move(x);
+        return x_;
+    }
+
+    constexpr const componentType& y() const {
+        return y_;
+    }
+
+    constexpr const componentType& y(componentType y) {
+        y_ = std::move(y);
+        return y_;
+    }
 };
 
-class Vector2D : public Point2D {
+template <typename ComponentType>
+class BasicVector2D : public BasicPoint2D<ComponentType> {
 public:
-    explicit Vector2D(componentType x = 0, componentType y = 0);
-    Vector2D(Point2D a, Point2D b);        //A - B vector
-    explicit Vector2D(Point2D);
-    Vector2D& operator+=(const Vector2D& other);
-    Vector2D& operator-=(const Vector2D& other);
-    Vector2D& operator*=(const componentType& scalar);
-    Vector2D& operator/=(const componentType& scalar);
-    Vector2D operator+(const Vector2D& other) const;
-    Vector2D operator-(const Vector2D& other) const;
-    Vector2D operator-() const;
-    componentType dot(const Vector2D &other) const;
-    componentType cross_z(const Vector2D &other) const;
+    typedef BasicPoint2D<ComponentType> pointType;
+    typedef ComponentType componentType;
+
+    using pointType::x;
+    using pointType::y;
+
+    constexpr explicit BasicVector2D(componentType x = componentType(), componentType y = componentType())
+            : pointType(std::move(x), std::move(y)) {}
+
+    //A - B vector
+    constexpr BasicVector2D(const pointType& a, const pointType& b) : pointType(a) {
+        *this -= BasicVector2D(b);
+    }
+
+    constexpr explicit BasicVector2D(const pointType& other) : pointType(other) {}
+
+    constexpr BasicVector2D& operator+=(const BasicVector2D& other) {
+        this->x_ += other.x_;
+        this->y_ += other.y_;
+        return *this;
+    }
+
+    constexpr BasicVector2D& operator-=(const BasicVector2D& other) {
+        this->x_ -= other.x_;
+        this->y_ -= other.y_;
+        return *this;
+    }
+
+    constexpr BasicVector2D& operator*=(const componentType& scalar) {
+        this->x_ *= scalar;
+        this->y_ *= scalar;
+        return *this;
+    }
+
+    constexpr BasicVector2D& operator/=(const componentType& scalar) {
+        this->x_ /= scalar;
+        this->y_ /= scalar;
+        return *this;
+    }
+
+    constexpr BasicVector2D operator+(const BasicVector2D& other) const {
+        auto result(*this);
+        return result += other;
+    }
+
+    constexpr BasicVector2D operator-(const BasicVector2D& other) const {
+        auto result(*this);
+        return result -= other;
+    }
+
+    constexpr BasicVector2D operator-() const {
+        return BasicVector2D() - *this;
+    }
+
+    constexpr componentType dot(const BasicVector2D& other) const {
+        return this->x_ * other.x_ + this->y_ * other.y_;
+    }
+
+    constexpr componentType cross_z(const BasicVector2D& other) const {
+        return this->x_ * other.y_ - this->y_ * other.x_;
+    }
 };
 
-Vector2D operator*(Vector2D vec, const Point2D::componentType& scalar);
-Vector2D operator*(const Point2D::componentType& scalar, Vector2D vec);
-Vector2D operator/(Vector2D vec, const Point2D::componentType& scalar);
\ No newline at end of file
+template <typename ComponentType>
+constexpr BasicVector2D<ComponentType> operator*(BasicVector2D<ComponentType> vec, const typename BasicVector2D<ComponentType>::componentType& scalar) {
+    return vec *= scalar;
+}
+
+template <typename ComponentType>
+constexpr BasicVector2D<ComponentType> operator*(const typename BasicVector2D<ComponentType>::componentType& scalar, BasicVector2D<ComponentType> vec) {
+    return vec *= scalar;
+}
+
+template <typename ComponentType>
+constexpr BasicVector2D<ComponentType> operator/(BasicVector2D<ComponentType> vec, const typename BasicVector2D<ComponentType>::componentType& scalar) {
+    return vec /= scalar;
+}
+
+typedef BasicPoint2D<double> Point2D;
+typedef BasicVector2D<double> Vector2D;
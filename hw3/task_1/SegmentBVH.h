@@ -0,0 +1,240 @@
+#pragma once
+
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <thread>
+#include <cstdint>
+#include "SegmentDistance.h"
+
+// Bounding volume hierarchy over 3D segments for nearest-segment queries.
+// Nodes live in one array in depth-first order: the left child of a node is the
+// next node, the right child is stored explicitly. Segments are reordered so that
+// every leaf owns a contiguous range of them.
+class SegmentBVH {
+public:
+    struct Segment {
+        Vector3D a, b;
+    };
+
+    struct Nearest {
+        size_t index = std::numeric_limits<size_t>::max();
+        double distance = std::numeric_limits<double>::infinity();
+    };
+
+private:
+    static constexpr size_t LEAF_SIZE = 4;
+    //nodes keep 32-bit indices to stay small, there are fewer nodes than segments
+    static constexpr size_t MAX_SEGMENTS = std::numeric_limits<uint32_t>::max();
+    //splits in halves down to leaves of LEAF_SIZE make the tree less than log2 of its size
+    //deep, and the traversal stack holds at most one node more than the depth
+    static constexpr size_t STACK_SIZE = 64;
+    static_assert(32 < STACK_SIZE, "the traversal stack must fit the deepest tree");
+
+    struct Box {
+        double min[3], max[3];
+    };
+
+    struct Node {
+        Box box;
+        uint32_t right;     //index of the right child, unused in leaves
+        uint32_t first;     //first segment of a leaf
+        uint32_t count;     //number of segments of a leaf, 0 for inner nodes
+    };
+
+    std::vector<Node> nodes;
+    std::vector<Segment> segments;
+    std::vector<size_t> original_index;
+
+    static size_t subtreeNodeCount(size_t count);
+    static Box segmentBox(const Segment &segment);
+    static double boxDistance(const Box &box, const Box &query);
+
+    void build(size_t node_id, size_t first, size_t count, size_t threads);
+
+    template <typename Distance>
+    Nearest nearest(const Box &query_box, Distance distance) const;
+
+public:
+    SegmentBVH() = default;
+    explicit SegmentBVH(const std::vector<Segment> &input, size_t threads = 1);
+    //for segments that are already in memory elsewhere, e.g. in a MappedArray
+    //more than MAX_SEGMENTS segments are rejected: the tree is left empty, size() is 0
+    SegmentBVH(const Segment *input, size_t count, size_t threads = 1);
+
+    Nearest nearestToSegment(const Vector3D &a, const Vector3D &b) const;
+    Nearest nearestToPoint(const Vector3D &point) const;
+
+    std::vector<Nearest> nearestToSegments(const std::vector<Segment> &queries, size_t threads = 1) const;
+    std::vector<Nearest> nearestToSegments(const Segment *queries, size_t count, size_t threads = 1) const;
+
+    size_t size() const;
+};
+
+
+// Splits are always by count in halves, so the node count of a subtree depends on
+// its size only and both children can be built in parallel at known offsets.
+inline size_t SegmentBVH::subtreeNodeCount(size_t count) {
+    if (count <= LEAF_SIZE) {
+        return 1;
+    }
+    return 1 + subtreeNodeCount(count / 2) + subtreeNodeCount(count - count / 2);
+}
+
+inline SegmentBVH::Box SegmentBVH::segmentBox(const Segment &segment) {
+    return {{std::min(segment.a.x, segment.b.x), std::min(segment.a.y, segment.b.y), std::min(segment.a.z, segment.b.z)},
+            {std::max(segment.a.x, segment.b.x), std::max(segment.a.y, segment.b.y), std::max(segment.a.z, segment.b.z)}};
+}
+
+// Distance between two boxes, which never exceeds the distance between anything inside them.
+inline double SegmentBVH::boxDistance(const Box &box, const Box &query) {
+    double squared = 0;
+    for (int axis = 0; axis < 3; ++axis) {
+        double gap = std::max({0., box.min[axis] - query.max[axis], query.min[axis] - box.max[axis]});
+        squared += gap * gap;
+    }
+    return sqrt(squared);
+}
+
+inline SegmentBVH::SegmentBVH(const std::vector<Segment> &input, size_t threads)
+        : SegmentBVH(input.data(), input.size(), threads) {}
+
+inline SegmentBVH::SegmentBVH(const Segment *input, size_t count, size_t threads) {
+    if (count > MAX_SEGMENTS) {
+        return;
+    }
+    segments.assign(input, input + count);
+    original_index.resize(count);
+    for (size_t i = 0; i < original_index.size(); ++i) {
+        original_index[i] = i;
+    }
+    if (segments.empty()) {
+        return;
+    }
+    nodes.resize(subtreeNodeCount(segments.size()));
+    build(0, 0, segments.size(), std::max<size_t>(threads, 1));
+
+    for (size_t i = 0; i < segments.size(); ++i) {
+        segments[i] = input[original_index[i]];
+    }
+}
+
+// Works on original_index only; segments are put in leaf order once the tree is built.
+inline void SegmentBVH::build(size_t node_id, size_t first, size_t count, size_t threads) {
+    Node &node = nodes[node_id];
+    node.box = segmentBox(segments[original_index[first]]);
+    for (size_t i = first + 1; i < first + count; ++i) {
+        Box box = segmentBox(segments[original_index[i]]);
+        for (int axis = 0; axis < 3; ++axis) {
+            node.box.min[axis] = std::min(node.box.min[axis], box.min[axis]);
+            node.box.max[axis] = std::max(node.box.max[axis], box.max[axis]);
+        }
+    }
+    if (count <= LEAF_SIZE) {
+        node.first = first;
+        node.count = count;
+        node.right = 0;
+        return;
+    }
+
+    int axis = 0;
+    for (int i = 1; i < 3; ++i) {
+        if (node.box.max[i] - node.box.min[i] > node.box.max[axis] - node.box.min[axis]) {
+            axis = i;
+        }
+    }
+    double Vector3D::*coordinate = axis == 0 ? &Vector3D::x : axis == 1 ? &Vector3D::y : &Vector3D::z;
+    auto centroid = [this, coordinate](size_t index) {
+        return segments[index].a.*coordinate + segments[index].b.*coordinate;
+    };
+
+    size_t left_count = count / 2;
+    auto begin = original_index.begin() + first;
+    std::nth_element(begin, begin + left_count, begin + count, [&](size_t lhs, size_t rhs) {
+        return centroid(lhs) < centroid(rhs);
+    });
+
+    node.count = 0;
+    node.right = node_id + 1 + subtreeNodeCount(left_count);
+    size_t right_id = node.right;
+
+    if (threads > 1) {
+        std::thread left_builder(&SegmentBVH::build, this, node_id + 1, first, left_count, threads / 2);
+        build(right_id, first + left_count, count - left_count, threads - threads / 2);
+        left_builder.join();
+    }
+    else {
+        build(node_id + 1, first, left_count, 1);
+        build(right_id, first + left_count, count - left_count, 1);
+    }
+}
+
+// Branch and bound: subtrees whose box is farther than the best distance found so
+// far are skipped, and the closer child is always visited first.
+template <typename Distance>
+SegmentBVH::Nearest SegmentBVH::nearest(const Box &query_box, Distance distance) const {
+    Nearest best;
+    if (nodes.empty()) {
+        return best;
+    }
+    uint32_t stack[STACK_SIZE];
+    size_t stack_size = 0;
+    stack[stack_size++] = 0;
+    while (stack_size) {
+        const Node &node = nodes[stack[--stack_size]];
+        if (boxDistance(node.box, query_box) >= best.distance) {
+            continue;
+        }
+        if (node.count) {
+            for (size_t i = node.first; i < node.first + node.count; ++i) {
+                double current = distance(segments[i]);
+                if (current < best.distance) {
+                    best.distance = current;
+                    best.index = original_index[i];
+                }
+            }
+            continue;
+        }
+        uint32_t left = &node - nodes.data() + 1;
+        uint32_t right = node.right;
+        double left_distance = boxDistance(nodes[left].box, query_box);
+        double right_distance = boxDistance(nodes[right].box, query_box);
+        if (left_distance < right_distance) {
+            std::swap(left, right);
+        }
+        stack[stack_size++] = left;
+        stack[stack_size++] = right;
+    }
+    return best;
+}
+
+inline SegmentBVH::Nearest SegmentBVH::nearestToSegment(const Vector3D &a, const Vector3D &b) const {
+    return nearest(segmentBox({a, b}), [&](const Segment &segment) {
+        return segmentDistance(a, b, segment.a, segment.b);
+    });
+}
+
+inline SegmentBVH::Nearest SegmentBVH::nearestToPoint(const Vector3D &point) const {
+    return nearest(segmentBox({point, point}), [&](const Segment &segment) {
+        return segmentDistance(point, point, segment.a, segment.b);
+    });
+}
+
+inline std::vector<SegmentBVH::Nearest> SegmentBVH::nearestToSegments(const std::vector<Segment> &queries, size_t threads) const {
+    return nearestToSegments(queries.data(), queries.size(), threads);
+}
+
+inline std::vector<SegmentBVH::Nearest> SegmentBVH::nearestToSegments(const Segment *queries, size_t count,
+                                                                      size_t threads) const {
+    std::vector<Nearest> result(count);
+    splitBetweenThreads(count, threads, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            result[i] = nearestToSegment(queries[i].a, queries[i].b);
+        }
+    });
+    return result;
+}
+
+inline size_t SegmentBVH::size() const {
+    return segments.size();
+}
@@ -0,0 +1,178 @@
+#pragma once
+
+#include <cmath>
+#include <algorithm>
+#include <vector>
+#include "../../common/Parallel.h"
+
+struct Vector3D {
+    double x, y, z;
+};
+
+inline Vector3D lerp(const Vector3D &a, const Vector3D &b, double bias) {
+    Vector3D result;
+    result.x = (1 - bias) * a.x + bias * b.x;
+    result.y = (1 - bias) * a.y + bias * b.y;
+    result.z = (1 - bias) * a.z + bias * b.z;
+    return result;
+}
+
+inline double vectorDistance(const Vector3D &a, const Vector3D &b) {
+    return sqrt((a.x - b.x) * (a.x - b.x)
+           + (a.y - b.y) * (a.y - b.y)
+           + (a.z - b.z) * (a.z - b.z));
+}
+
+inline Vector3D difference(const Vector3D &a, const Vector3D &b) {
+    return {a.x - b.x, a.y - b.y, a.z - b.z};
+}
+
+inline double dot(const Vector3D &a, const Vector3D &b) {
+    return a.x * b.x + a.y * b.y + a.z * b.z;
+}
+
+// Closest points a1 + s * (a2 - a1) and b1 + t * (b2 - b1) minimize a quadratic in (s, t):
+// solve it unconstrained, clamp s, recompute t for that s and clamp it, then refit s
+// if t was clamped. Parallel and point-like segments only change which value the
+// selects pick, so the kernel has no branches and vectorizes over batches.
+template <typename T>
+inline __attribute__((always_inline))
+T segmentDistanceKernel(T a1x, T a1y, T a1z, T a2x, T a2y, T a2z,
+                        T b1x, T b1y, T b1z, T b2x, T b2y, T b2z) {
+    T d1x = a2x - a1x, d1y = a2y - a1y, d1z = a2z - a1z;
+    T d2x = b2x - b1x, d2y = b2y - b1y, d2z = b2z - b1z;
+    T rx = a1x - b1x, ry = a1y - b1y, rz = a1z - b1z;
+    T a = d1x * d1x + d1y * d1y + d1z * d1z;
+    T e = d2x * d2x + d2y * d2y + d2z * d2z;
+    T b = d1x * d2x + d1y * d2y + d1z * d2z;
+    T c = d1x * rx + d1y * ry + d1z * rz;
+    T f = d2x * rx + d2y * ry + d2z * rz;
+
+    T denominator = a * e - b * b;
+    T s_free = denominator > 0 ? std::clamp((b * f - c * e) / (denominator > 0 ? denominator : 1), T(0), T(1)) : T(0);
+    T t_free = e > 0 ? (b * s_free + f) / (e > 0 ? e : 1) : T(0);
+    T t = std::clamp(t_free, T(0), T(1));
+    T s_refit = a > 0 ? std::clamp((b * t - c) / (a > 0 ? a : 1), T(0), T(1)) : T(0);
+    T s = (t != t_free || e == 0) ? s_refit : s_free;
+
+    T px = rx + s * d1x - t * d2x;
+    T py = ry + s * d1y - t * d2y;
+    T pz = rz + s * d1z - t * d2z;
+    return std::sqrt(px * px + py * py + pz * pz);
+}
+
+inline double segmentDistance(const Vector3D &a1, const Vector3D &a2, const Vector3D &b1, const Vector3D &b2) {
+    return segmentDistanceKernel(a1.x, a1.y, a1.z, a2.x, a2.y, a2.z,
+                                 b1.x, b1.y, b1.z, b2.x, b2.y, b2.z);
+}
+
+
+// Structure-of-arrays segment set: the i-th segment goes from (x1[i], y1[i], z1[i])
+// to (x2[i], y2[i], z2[i]). Kernels load each coordinate as a contiguous vector.
+template <typename T>
+struct SegmentSet {
+    std::vector<T> x1, y1, z1, x2, y2, z2;
+
+    size_t size() const {
+        return x1.size();
+    }
+
+    void push_back(const Vector3D &a, const Vector3D &b) {
+        x1.push_back(a.x);
+        y1.push_back(a.y);
+        z1.push_back(a.z);
+        x2.push_back(b.x);
+        y2.push_back(b.y);
+        z2.push_back(b.z);
+    }
+};
+
+template <typename T>
+inline __attribute__((always_inline))
+void pairedSegmentDistancesLoop(const SegmentSet<T> &first, const SegmentSet<T> &second,
+                                 T *result, size_t from, size_t to) {
+    const T *a1x = first.x1.data(), *a1y = first.y1.data(), *a1z = first.z1.data();
+    const T *a2x = first.x2.data(), *a2y = first.y2.data(), *a2z = first.z2.data();
+    const T *b1x = second.x1.data(), *b1y = second.y1.data(), *b1z = second.z1.data();
+    const T *b2x = second.x2.data(), *b2y = second.y2.data(), *b2z = second.z2.data();
+#pragma omp simd
+    for (size_t i = from; i < to; ++i) {
+        result[i] = segmentDistanceKernel(a1x[i], a1y[i], a1z[i], a2x[i], a2y[i], a2z[i],
+                                          b1x[i], b1y[i], b1z[i], b2x[i], b2y[i], b2z[i]);
+    }
+}
+
+template <typename T>
+inline __attribute__((always_inline))
+void pairwiseSegmentDistancesLoop(const SegmentSet<T> &first, const SegmentSet<T> &second,
+                                   T *result, size_t from, size_t to) {
+    const size_t columns = second.size();
+    const T *b1x = second.x1.data(), *b1y = second.y1.data(), *b1z = second.z1.data();
+    const T *b2x = second.x2.data(), *b2y = second.y2.data(), *b2z = second.z2.data();
+    for (size_t i = from; i < to; ++i) {
+        const T a1x = first.x1[i], a1y = first.y1[i], a1z = first.z1[i];
+        const T a2x = first.x2[i], a2y = first.y2[i], a2z = first.z2[i];
+        T *row = result + i * columns;
+#pragma omp simd
+        for (size_t j = 0; j < columns; ++j) {
+            row[j] = segmentDistanceKernel(a1x, a1y, a1z, a2x, a2y, a2z,
+                                           b1x[j], b1y[j], b1z[j], b2x[j], b2y[j], b2z[j]);
+        }
+    }
+}
+
+// The per-ISA clones are picked at load time, so the same binary runs the
+// AVX-512 or AVX2 version of the loops where the CPU supports it.
+#define SEGMENT_BATCH_TARGETS __attribute__((target_clones("avx512f", "avx2", "default")))
+
+SEGMENT_BATCH_TARGETS
+inline void pairedSegmentDistancesRange(const SegmentSet<float> &first, const SegmentSet<float> &second,
+                                        float *result, size_t from, size_t to) {
+    pairedSegmentDistancesLoop(first, second, result, from, to);
+}
+
+SEGMENT_BATCH_TARGETS
+inline void pairedSegmentDistancesRange(const SegmentSet<double> &first, const SegmentSet<double> &second,
+                                        double *result, size_t from, size_t to) {
+    pairedSegmentDistancesLoop(first, second, result, from, to);
+}
+
+SEGMENT_BATCH_TARGETS
+inline void pairwiseSegmentDistancesRange(const SegmentSet<float> &first, const SegmentSet<float> &second,
+                                          float *result, size_t from, size_t to) {
+    pairwiseSegmentDistancesLoop(first, second, result, from, to);
+}
+
+SEGMENT_BATCH_TARGETS
+inline void pairwiseSegmentDistancesRange(const SegmentSet<double> &first, const SegmentSet<double> &second,
+                                          double *result, size_t from, size_t to) {
+    pairwiseSegmentDistancesLoop(first, second, result, from, to);
+}
+
+#undef SEGMENT_BATCH_TARGETS
+
+// result[i] = distance between first[i] and second[i]. Sets of different sizes have no
+// pairing, and the result is empty then.
+template <typename T>
+std::vector<T> pairedSegmentDistances(const SegmentSet<T> &first, const SegmentSet<T> &second,
+                                      size_t threads = 1) {
+    if (first.size() != second.size()) {
+        return {};
+    }
+    std::vector<T> result(first.size());
+    splitBetweenThreads(first.size(), threads, [&](size_t from, size_t to) {
+        pairedSegmentDistancesRange(first, second, result.data(), from, to);
+    });
+    return result;
+}
+
+// result[i * second.size() + j] = distance between first[i] and second[j].
+template <typename T>
+std::vector<T> pairwiseSegmentDistances(const SegmentSet<T> &first, const SegmentSet<T> &second,
+                                        size_t threads = 1) {
+    std::vector<T> result(first.size() * second.size());
+    splitBetweenThreads(first.size(), threads, [&](size_t from, size_t to) {
+        pairwiseSegmentDistancesRange(first, second, result.data(), from, to);
+    });
+    return result;
+}
@@ -1,33 +1,25 @@
 #include <iostream>
 #include <limits>
 #include <cmath>
+#include <algorithm>
+#include <random>
+#include <string>
+#include <iomanip>
+#include <chrono>
+#include <numeric>
+#include "SegmentDistance.h"
+#include "SegmentBVH.h"
+#include "../task_0/GeometryIO.h"
 
 const double FLOAT_PRECISION = 1e-10;
 
-struct Vector3D {
-    double x, y, z;
-};
-
-std::istream &operator>>(std::istream &is, Vector3D &vec) {
-    is >> vec.x >> vec.y >> vec.z;
-    return is;
-}
-
-Vector3D lerp(const Vector3D &a, const Vector3D &b, double bias) {
-    Vector3D result;
-    result.x = (1 - bias) * a.x + bias * b.x;
-    result.y = (1 - bias) * a.y + bias * b.y;
-    result.z = (1 - bias) * a.z + bias * b.z;
-    return result;
+bool readVector(FastInput &input, Vector3D &vec) {
+    return input.read(vec.x) && input.read(vec.y) && input.read(vec.z);
 }
 
-double vectorDistance(const Vector3D &a, const Vector3D &b) {
-    return sqrt((a.x - b.x) * (a.x - b.x)
-           + (a.y - b.y) * (a.y - b.y)
-           + (a.z - b.z) * (a.z - b.z));
-}
+const char SEGMENTS_TAG[] = "SEGM3D";
 
-double segmentDistance(Vector3D a1, Vector3D a2, const Vector3D& b1, const Vector3D& b2) {
+double segmentDistanceTernary(Vector3D a1, Vector3D a2, const Vector3D& b1, const Vector3D& b2) {
     double min_dist_prev = std::numeric_limits<double>::max();
     while (true) {
         Vector3D a_first = lerp(a1, a2, 1. / 4);
@@ -41,8 +33,8 @@ double segmentDistance(Vector3D a1, Vector3D a2, const Vector3D& b1, const Vecto
             min_dist_first = vectorDistance(a_first, b1);
             min_dist_second = vectorDistance(a_second, b1);
         } else {
-            min_dist_first = segmentDistance(b1, b2, a_first, a_first);
-            min_dist_second = segmentDistance(b1, b2, a_second, a_second);
+            min_dist_first = segmentDistanceTernary(b1, b2, a_first, a_first);
+            min_dist_second = segmentDistanceTernary(b1, b2, a_second, a_second);
         }
 
         if (min_dist_first < min_dist_second) {
@@ -61,11 +53,228 @@ double segmentDistance(Vector3D a1, Vector3D a2, const Vector3D& b1, const Vecto
     }
 }
 
-int main() {
+// Compares the analytic solver against the ternary search on random segments,
+// including parallel and degenerate ones. Returns the number of mismatches.
+int crossCheckSegmentDistance(size_t tries) {
+    std::mt19937_64 rd(tries);
+    std::uniform_int_distribution<int> ds_coordinate(-20, 20);
+    auto random_point = [&]() {
+        return Vector3D{ds_coordinate(rd) / 2., ds_coordinate(rd) / 2., ds_coordinate(rd) / 2.};
+    };
+    int mismatches = 0;
+    for (size_t i = 0; i < tries; ++i) {
+        Vector3D a1 = random_point(), a2 = random_point(), b1 = random_point(), b2 = random_point();
+        switch (i % 4) {
+            case 1:                             //parallel
+                b2 = {b1.x + (a2.x - a1.x) * 2, b1.y + (a2.y - a1.y) * 2, b1.z + (a2.z - a1.z) * 2};
+                break;
+            case 2:                             //first segment is a point
+                a2 = a1;
+                break;
+            case 3:                             //both segments are points
+                a2 = a1;
+                b2 = b1;
+                break;
+        }
+        double analytic = segmentDistance(a1, a2, b1, b2);
+        double ternary = segmentDistanceTernary(a1, a2, b1, b2);
+        //ternary search may stop slightly above the minimum, but never below it
+        if (analytic > ternary + FLOAT_PRECISION || ternary - analytic > 1e-4) {
+            ++mismatches;
+            std::cout << "Mismatch: " << analytic << " vs " << ternary << '\n';
+        }
+    }
+    return mismatches;
+}
+
+// Compares the batch API in both precisions against the scalar solver.
+int crossCheckBatchDistances(size_t size) {
+    std::mt19937_64 rd(size);
+    std::uniform_real_distribution<double> ds_coordinate(-10, 10);
+    SegmentSet<double> first, second;
+    SegmentSet<float> first_float, second_float;
+    for (size_t i = 0; i < size; ++i) {
+        Vector3D a1{ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)};
+        Vector3D a2 = i % 5 ? Vector3D{ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)} : a1;
+        Vector3D b1{ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)};
+        Vector3D b2{ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)};
+        first.push_back(a1, a2);
+        second.push_back(b1, b2);
+        first_float.push_back(a1, a2);
+        second_float.push_back(b1, b2);
+    }
+    auto segment = [](const SegmentSet<double> &set, size_t i, bool end) {
+        return end ? Vector3D{set.x2[i], set.y2[i], set.z2[i]} : Vector3D{set.x1[i], set.y1[i], set.z1[i]};
+    };
+    auto expected = [&](size_t i, size_t j) {
+        return segmentDistance(segment(first, i, 0), segment(first, i, 1), segment(second, j, 0), segment(second, j, 1));
+    };
+
+    int mismatches = 0;
+    auto paired = pairedSegmentDistances(first, second, 4);
+    auto paired_float = pairedSegmentDistances(first_float, second_float);
+    for (size_t i = 0; i < size; ++i) {
+        mismatches += fabs(paired[i] - expected(i, i)) > FLOAT_PRECISION;
+        mismatches += fabs(paired_float[i] - expected(i, i)) > 1e-3;
+    }
+    mismatches += !pairedSegmentDistances(first, SegmentSet<double>()).empty();
+    auto pairwise = pairwiseSegmentDistances(first, second, 3);
+    for (size_t i = 0; i < size; ++i) {
+        for (size_t j = 0; j < size; ++j) {
+            mismatches += fabs(pairwise[i * size + j] - expected(i, j)) > FLOAT_PRECISION;
+        }
+    }
+    return mismatches;
+}
+
+std::vector<SegmentBVH::Segment> randomSegments(size_t size, double max_length, unsigned long long seed) {
+    std::mt19937_64 rd(seed);
+    std::uniform_real_distribution<double> ds_coordinate(-100, 100);
+    std::uniform_real_distribution<double> ds_offset(-max_length, max_length);
+    std::vector<SegmentBVH::Segment> segments(size);
+    for (auto &segment : segments) {
+        segment.a = {ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)};
+        segment.b = {segment.a.x + ds_offset(rd), segment.a.y + ds_offset(rd), segment.a.z + ds_offset(rd)};
+    }
+    return segments;
+}
+
+// Compares nearest-segment queries of the BVH against a linear scan.
+int crossCheckSegmentBVH(size_t size, size_t queries) {
+    auto segments = randomSegments(size, 5, size);
+    auto query_segments = randomSegments(queries, 20, queries);
+    SegmentBVH bvh(segments, 4);
+    auto batch = bvh.nearestToSegments(query_segments, 2);
+
+    int mismatches = 0;
+    for (size_t i = 0; i < queries; ++i) {
+        const auto &query = query_segments[i];
+        double expected = std::numeric_limits<double>::infinity();
+        double expected_point = std::numeric_limits<double>::infinity();
+        for (const auto &segment : segments) {
+            expected = std::min(expected, segmentDistance(query.a, query.b, segment.a, segment.b));
+            expected_point = std::min(expected_point, segmentDistance(query.a, query.a, segment.a, segment.b));
+        }
+        mismatches += fabs(bvh.nearestToSegment(query.a, query.b).distance - expected) > FLOAT_PRECISION;
+        mismatches += fabs(batch[i].distance - expected) > FLOAT_PRECISION;
+        mismatches += fabs(bvh.nearestToPoint(query.a).distance - expected_point) > FLOAT_PRECISION;
+    }
+    return mismatches;
+}
+
+void benchmarkSegmentBVH(size_t size, size_t queries) {
+    auto segments = randomSegments(size, 1, size);
+    auto query_segments = randomSegments(queries, 1, queries);
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto time_start = std::chrono::steady_clock::now();
+    SegmentBVH bvh(segments, threads);
+    auto time_end = std::chrono::steady_clock::now();
+    std::cout << std::left << std::setw(28) << "Build, ms" << (time_end - time_start).count() / 1000000 << '\n';
+
+    time_start = std::chrono::steady_clock::now();
+    auto nearest = bvh.nearestToSegments(query_segments, threads);
+    time_end = std::chrono::steady_clock::now();
+    std::cout << std::setw(28) << "Queries, ns per query" << (time_end - time_start).count() / queries << '\n';
+}
+
+void benchmarkBatchDistances(size_t size) {
+    std::mt19937_64 rd(size);
+    std::uniform_real_distribution<double> ds_coordinate(-10, 10);
+    std::vector<Vector3D> points;
+    SegmentSet<double> first, second;
+    SegmentSet<float> first_float, second_float;
+    for (size_t i = 0; i < 2 * size; ++i) {
+        points.push_back({ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)});
+        points.push_back({ds_coordinate(rd), ds_coordinate(rd), ds_coordinate(rd)});
+        (i < size ? first : second).push_back(points[2 * i], points[2 * i + 1]);
+        (i < size ? first_float : second_float).push_back(points[2 * i], points[2 * i + 1]);
+    }
+
+    auto measure = [](auto function) {
+        auto time_start = std::chrono::steady_clock::now();
+        double checksum = function();
+        auto time_end = std::chrono::steady_clock::now();
+        std::cout << std::setw(14) << (time_end - time_start).count() / 1000000 << checksum << '\n';
+    };
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    std::cout << std::left << "Paired distances, " << size << " pairs" << '\n';
+    std::cout << std::setw(28) << "Time, ms" << std::setw(14) << "" << "Checksum" << '\n';
+    std::cout << std::setw(28) << "scalar";
+    measure([&]() {
+        double sum = 0;
+        for (size_t i = 0; i < size; ++i) {
+            sum += segmentDistance(points[2 * i], points[2 * i + 1], points[2 * (i + size)], points[2 * (i + size) + 1]);
+        }
+        return sum;
+    });
+    std::cout << std::setw(28) << "batch double";
+    measure([&]() {
+        auto result = pairedSegmentDistances(first, second);
+        return std::accumulate(result.begin(), result.end(), 0.);
+    });
+    std::cout << std::setw(28) << "batch float";
+    measure([&]() {
+        auto result = pairedSegmentDistances(first_float, second_float);
+        return std::accumulate(result.begin(), result.end(), 0.);
+    });
+    std::cout << std::setw(28) << "batch double, all threads";
+    measure([&]() {
+        auto result = pairedSegmentDistances(first, second, threads);
+        return std::accumulate(result.begin(), result.end(), 0.);
+    });
+}
+
+// Answers nearest-segment queries for two mapped binary segment files,
+// one distance per line.
+int answerBinaryQueries(const std::string &segments_path, const std::string &queries_path) {
+    MappedArray<SegmentBVH::Segment> segments, queries;
+    if (!segments.open(segments_path, SEGMENTS_TAG) || !queries.open(queries_path, SEGMENTS_TAG)) {
+        std::cerr << "Can't read binary segment files" << '\n';
+        return 1;
+    }
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+    SegmentBVH bvh(segments.data(), segments.size(), threads);
+    auto nearest = bvh.nearestToSegments(queries.data(), queries.size(), threads);
+    FastOutput output;
+    for (const auto &result : nearest) {
+        output.write(result.distance, std::chars_format::fixed, 7);
+        output.write('\n');
+    }
+    return 0;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 3 && std::string(argv[1]) == "--generate-binary") {
+        auto segments = randomSegments(std::stoull(argv[3]), 1, std::stoull(argv[3]));
+        return !writeBinaryArray(argv[2], SEGMENTS_TAG, segments);
+    }
+    if (argc > 3 && std::string(argv[1]) == "--binary") {
+        return answerBinaryQueries(argv[2], argv[3]);
+    }
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-batch") {
+        benchmarkBatchDistances(argc > 2 ? std::stoull(argv[2]) : 10000000);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-bvh") {
+        benchmarkSegmentBVH(argc > 2 ? std::stoull(argv[2]) : 1000000, 100000);
+        return 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check") {
+        int mismatches = crossCheckSegmentDistance(10000) + crossCheckBatchDistances(300)
+                         + crossCheckSegmentBVH(3000, 300);
+        std::cout << mismatches << " mismatches" << '\n';
+        return mismatches != 0;
+    }
+
+    FastInput input;
     Vector3D a1, a2, b1, b2;
-    std::cin >> a1 >> a2 >> b1 >> b2;
-    std::cout.setf(std::ostream::fixed, std::ostream::floatfield);
-    std::cout.precision(7);
-    std::cout << segmentDistance(a1, a2, b1, b2);
+    if (!(readVector(input, a1) && readVector(input, a2) && readVector(input, b1) && readVector(input, b2))) {
+        std::cerr << "Expected two segments, 12 coordinates" << '\n';
+        return 1;
+    }
+    FastOutput output;
+    output.write(segmentDistance(a1, a2, b1, b2), std::chars_format::fixed, 7);
     return 0;
 }
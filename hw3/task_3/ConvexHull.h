@@ -0,0 +1,137 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "../task_0/Primitives2D.h"
+#include "../task_0/Predicates2D.h"
+#include "../../common/Parallel.h"
+
+// Convex hull of a point cloud as a counter-clockwise polygon without collinear
+// vertices, ready to be fed to minkowski_sum.
+
+inline bool lexicographically_less(const Vector2D &a, const Vector2D &b) {
+    return a.x() < b.x() || (a.x() == b.x() && a.y() < b.y());
+}
+
+// Akl-Toussaint heuristic: points strictly inside the polygon of the extreme points in
+// the directions x, y, x + y and x - y can't be on the hull. On typical clouds this
+// throws away almost everything before sorting.
+inline std::vector<Vector2D> akl_toussaint_filter(const std::vector<Vector2D> &points, size_t threads = 1) {
+    if (points.size() < 8) {
+        return points;
+    }
+    size_t extreme[8] = {};     //minimizers of the keys below, counter-clockwise from the leftmost point
+    auto key = [](const Vector2D &point, int direction) {
+        switch (direction) {
+            case 0: return point.x();
+            case 1: return point.x() + point.y();
+            case 2: return point.y();
+            case 3: return point.y() - point.x();
+            case 4: return -point.x();
+            case 5: return -point.x() - point.y();
+            case 6: return -point.y();
+            default: return point.x() - point.y();
+        }
+    };
+    for (size_t i = 1; i < points.size(); ++i) {
+        for (int direction = 0; direction < 8; ++direction) {
+            if (key(points[i], direction) < key(points[extreme[direction]], direction)) {
+                extreme[direction] = i;
+            }
+        }
+    }
+    std::vector<Vector2D> octagon;
+    for (int direction = 0; direction < 8; ++direction) {
+        const Vector2D &point = points[extreme[direction]];
+        if (octagon.empty() || !(octagon.back() == point)) {
+            octagon.push_back(point);
+        }
+    }
+    while (octagon.size() > 1 && octagon.back() == octagon.front()) {
+        octagon.pop_back();
+    }
+    if (octagon.size() < 3) {
+        return points;
+    }
+
+    const size_t chunks = std::max<size_t>(threads, 1);
+    std::vector<std::vector<Vector2D>> kept(chunks);
+    splitBetweenThreads(chunks, chunks, [&](size_t first_chunk, size_t last_chunk) {
+        for (size_t chunk = first_chunk; chunk < last_chunk; ++chunk) {
+            size_t from = points.size() * chunk / chunks, to = points.size() * (chunk + 1) / chunks;
+            for (size_t i = from; i < to; ++i) {
+                bool strictly_inside = true;
+                for (size_t k = 0; k < octagon.size() && strictly_inside; ++k) {
+                    const Vector2D &next = octagon[k + 1 == octagon.size() ? 0 : k + 1];
+                    strictly_inside = orientation(octagon[k], next, points[i]) > 0;
+                }
+                if (!strictly_inside) {
+                    kept[chunk].push_back(points[i]);
+                }
+            }
+        }
+    });
+    std::vector<Vector2D> result;
+    for (const auto &part : kept) {
+        result.insert(result.end(), part.begin(), part.end());
+    }
+    return result;
+}
+
+// Sorts chunks on separate threads, then merges neighbouring runs pairwise, also in parallel.
+inline void parallel_sort(std::vector<Vector2D> &points, size_t threads) {
+    threads = std::max<size_t>(1, std::min(threads, points.size() / 4096 + 1));
+    std::vector<size_t> bounds;
+    for (size_t i = 0; i <= threads; ++i) {
+        bounds.push_back(points.size() * i / threads);
+    }
+    splitBetweenThreads(threads, threads, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            std::sort(points.begin() + bounds[i], points.begin() + bounds[i + 1], lexicographically_less);
+        }
+    });
+    for (size_t width = 1; width < threads; width *= 2) {
+        size_t merges = (threads + 2 * width - 1) / (2 * width);
+        splitBetweenThreads(merges, merges, [&](size_t from, size_t to) {
+            for (size_t i = from; i < to; ++i) {
+                size_t left = 2 * width * i;
+                size_t middle = std::min(left + width, threads);
+                size_t right = std::min(left + 2 * width, threads);
+                std::inplace_merge(points.begin() + bounds[left], points.begin() + bounds[middle],
+                                   points.begin() + bounds[right], lexicographically_less);
+            }
+        });
+    }
+}
+
+// Andrew's monotone chain over lexicographically sorted points with exact turns. The points
+// must be distinct: repeats of one point would come out as a hull of two equal vertices.
+inline std::vector<Vector2D> monotone_chain(const std::vector<Vector2D> &sorted) {
+    const size_t n = sorted.size();
+    if (n < 3) {
+        return sorted;
+    }
+    std::vector<Vector2D> hull(2 * n);
+    size_t size = 0;
+    for (size_t i = 0; i < n; ++i) {
+        while (size >= 2 && orientation(hull[size - 2], hull[size - 1], sorted[i]) <= 0) {
+            --size;
+        }
+        hull[size++] = sorted[i];
+    }
+    for (size_t i = n - 1, lower_size = size + 1; i > 0; --i) {
+        while (size >= lower_size && orientation(hull[size - 2], hull[size - 1], sorted[i - 1]) <= 0) {
+            --size;
+        }
+        hull[size++] = sorted[i - 1];
+    }
+    hull.resize(size - 1);          //the first point is repeated at the end
+    return hull;
+}
+
+inline std::vector<Vector2D> convex_hull(const std::vector<Vector2D> &points, size_t threads = 1) {
+    std::vector<Vector2D> candidates = akl_toussaint_filter(points, threads);
+    parallel_sort(candidates, threads);
+    candidates.erase(std::unique(candidates.begin(), candidates.end()), candidates.end());
+    return monotone_chain(candidates);
+}
@@ -0,0 +1,156 @@
+#pragma once
+
+#include <vector>
+#include <algorithm>
+#include "../task_0/Primitives2D.h"
+#include "../task_0/Predicates2D.h"
+
+// Lowest vertex, the leftmost of them on ties: edges of a convex counter-clockwise
+// polygon go from it in increasing polar angle.
+inline size_t lowest_vertex(const Vector2D *polygon, size_t n) {
+    size_t lowest = 0;
+    for (size_t i = 1; i < n; ++i) {
+        auto cur = polygon[i];
+        auto prev = polygon[lowest];
+        if (cur.y() < prev.y() || (cur.y() == prev.y() && cur.x() < prev.x())) {
+            lowest = i;
+        }
+    }
+    return lowest;
+}
+
+inline size_t lowest_vertex(const std::vector<Vector2D> &polygon) {
+    return lowest_vertex(polygon.data(), polygon.size());
+}
+
+// Convex counter-clockwise polygon prepared for point location: the vertices are
+// rotated to start at the lowest one and seen as a fan of triangles from it, so a
+// query is a binary search over the fan followed by one edge test.
+class ConvexPolygon {
+private:
+    std::vector<Point2D> vertices;
+
+    size_t locate(const Point2D &point, size_t &hint) const;
+    bool contains(const Point2D &point, size_t &hint) const;
+
+public:
+    explicit ConvexPolygon(const std::vector<Vector2D> &polygon);
+
+    // Points on the border count as contained.
+    bool contains(const Point2D &point) const;
+
+    // Starts the search from the fan triangle of the previous query, so points that
+    // come sorted by angle or with spatial locality cost O(log distance) each.
+    std::vector<char> contains(const std::vector<Vector2D> &points) const;
+
+    size_t size() const;
+};
+
+
+// Repeated vertices and vertices in the middle of an edge are dropped: the fan
+// triangle of such a vertex would be degenerate, and the binary search could land on
+// it and accept points on the ray from vertices[0] beyond the polygon. The lowest
+// vertex is always a corner, so vertices[0] stays.
+inline ConvexPolygon::ConvexPolygon(const std::vector<Vector2D> &polygon) {
+    auto between = [](const Point2D &a, const Point2D &b, const Point2D &c) {
+        return orientation(a, b, c) == 0
+               && std::min(a.x(), c.x()) <= b.x() && b.x() <= std::max(a.x(), c.x())
+               && std::min(a.y(), c.y()) <= b.y() && b.y() <= std::max(a.y(), c.y());
+    };
+    const size_t n = polygon.size(), offset = lowest_vertex(polygon);
+    vertices.reserve(n);
+    for (size_t k = 0; k < n; ++k) {
+        const Point2D &point = polygon[offset + k < n ? offset + k : offset + k - n];
+        while (vertices.size() >= 2 && between(vertices[vertices.size() - 2], vertices.back(), point)) {
+            vertices.pop_back();
+        }
+        if (vertices.empty() || !(vertices.back() == point)) {
+            vertices.push_back(point);
+        }
+    }
+    while (vertices.size() >= 3 && between(vertices[vertices.size() - 2], vertices.back(), vertices[0])) {
+        vertices.pop_back();
+    }
+}
+
+// Returns the last fan index k in [1, n - 2] with the point not to the right of
+// vertices[0] -> vertices[k], or 0 if the point is outside of the fan.
+inline size_t ConvexPolygon::locate(const Point2D &point, size_t &hint) const {
+    const size_t n = vertices.size();
+    const Point2D &origin = vertices[0];
+    if (orientation(origin, vertices[1], point) < 0 || orientation(origin, vertices[n - 1], point) > 0) {
+        return 0;
+    }
+    auto not_right = [&](size_t k) {
+        return orientation(origin, vertices[k], point) >= 0;
+    };
+
+    //galloping from the hint to bracket the answer, then binary search inside
+    size_t low, high;      //not_right(low) holds, not_right(high) does not, or high == n - 1
+    hint = std::min(std::max<size_t>(hint, 1), n - 2);
+    if (not_right(hint)) {
+        low = hint;
+        size_t step = 1;
+        high = low + step;
+        while (high < n - 1 && not_right(high)) {
+            low = high;
+            step *= 2;
+            high = std::min(low + step, n - 1);
+        }
+    }
+    else {
+        high = hint;
+        size_t step = 1;
+        low = high > step ? high - step : 1;
+        while (low > 1 && !not_right(low)) {
+            high = low;
+            step *= 2;
+            low = high > step + 1 ? high - step : 1;
+        }
+    }
+    while (high - low > 1) {
+        size_t middle = low + (high - low) / 2;
+        if (not_right(middle)) {
+            low = middle;
+        }
+        else {
+            high = middle;
+        }
+    }
+    hint = low;
+    return low;
+}
+
+inline bool ConvexPolygon::contains(const Point2D &point, size_t &hint) const {
+    const size_t n = vertices.size();
+    if (n == 0) {
+        return false;
+    }
+    if (n == 1) {
+        return point == vertices[0];
+    }
+    if (n == 2) {
+        return orientation(vertices[0], vertices[1], point) == 0
+               && Vector2D(vertices[0], point).dot(Vector2D(vertices[1], point)) <= 0;
+    }
+    size_t k = locate(point, hint);
+    return k && orientation(vertices[k], vertices[k + 1], point) >= 0;
+}
+
+inline bool ConvexPolygon::contains(const Point2D &point) const {
+    size_t hint = vertices.size() / 2;
+    return contains(point, hint);
+}
+
+inline std::vector<char> ConvexPolygon::contains(const std::vector<Vector2D> &points) const {
+    std::vector<char> result(points.size());
+    size_t hint = vertices.size() / 2;
+    for (size_t i = 0; i < points.size(); ++i) {
+        result[i] = contains(points[i], hint);
+    }
+    return result;
+}
+
+inline size_t ConvexPolygon::size() const {
+    return vertices.size();
+}
@@ -0,0 +1,250 @@
+#pragma once
+
+#include <vector>
+#include <cmath>
+#include <utility>
+#include "../task_0/Primitives2D.h"
+#include "../../common/Parallel.h"
+#include "Minkowski.h"
+
+// Intersection and penetration queries for convex polygons with GJK and EPA. Both work
+// on the Minkowski difference first - second only through its support function, so
+// nothing of size n + m is ever built. Polygons that only touch count as intersecting,
+// the same as for zero_in_polygon.
+
+struct CollisionResult {
+    bool intersect = false;
+    double depth = 0;           //penetration depth, 0 if the polygons don't intersect
+    Vector2D normal;            //unit direction to move second by depth to separate them
+};
+
+// Vertex of a convex polygon furthest along direction. The dot product is unimodal
+// along the border of a convex polygon, so hill climbing from the previous answer
+// finds it in a few steps when directions change gradually. Collinear vertices make
+// plateaus where both neighbours tie, which may be the minimum as well as the maximum,
+// so there the answer comes from a full scan.
+inline size_t support_index(const std::vector<Vector2D> &polygon, const Vector2D &direction, size_t hint) {
+    const size_t n = polygon.size();
+    size_t best = hint < n ? hint : 0;
+    double best_value = polygon[best].dot(direction);
+    while (true) {
+        size_t next = best + 1 == n ? 0 : best + 1;
+        size_t prev = best == 0 ? n - 1 : best - 1;
+        double next_value = polygon[next].dot(direction);
+        double prev_value = polygon[prev].dot(direction);
+        if (next_value > best_value && next_value >= prev_value) {
+            best = next;
+            best_value = next_value;
+        }
+        else if (prev_value > best_value) {
+            best = prev;
+            best_value = prev_value;
+        }
+        else if (n > 2 && next_value == best_value && prev_value == best_value) {
+            for (size_t i = 0; i < n; ++i) {
+                double value = polygon[i].dot(direction);
+                if (value > best_value) {
+                    best = i;
+                    best_value = value;
+                }
+            }
+            return best;
+        }
+        else {
+            return best;
+        }
+    }
+}
+
+class MinkowskiDifferenceSupport {
+private:
+    const std::vector<Vector2D> &first;
+    const std::vector<Vector2D> &second;
+    size_t first_hint = 0;
+    size_t second_hint = 0;
+
+public:
+    MinkowskiDifferenceSupport(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second)
+            : first(first), second(second) {}
+
+    Vector2D operator()(const Vector2D &direction) {
+        first_hint = support_index(first, direction, first_hint);
+        second_hint = support_index(second, -direction, second_hint);
+        return first[first_hint] - second[second_hint];
+    }
+};
+
+// Direction perpendicular to segment, pointing to the side of toward.
+inline Vector2D perpendicular_towards(const Vector2D &segment, const Vector2D &toward) {
+    Vector2D normal(-segment.y(), segment.x());
+    return normal.dot(toward) >= 0 ? normal : -normal;
+}
+
+// Exact intersection test through the whole Minkowski difference, for the inputs GJK
+// doesn't settle within its iteration budget.
+inline bool minkowski_intersect(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second) {
+    std::vector<Vector2D> negated, difference;
+    negated.reserve(second.size());
+    for (const auto &vertex : second) {
+        negated.push_back(-vertex);
+    }
+    MinkowskiWorkspace workspace;
+    minkowski_sum_into(first, negated, difference, workspace);
+    return zero_in_polygon(difference);
+}
+
+// Runs GJK and leaves in simplex a triangle containing the origin if the polygons
+// intersect and a non-degenerate triangle exists.
+inline bool gjk(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second,
+                std::vector<Vector2D> &simplex) {
+    const int max_iterations = 64 + 2 * (first.size() + second.size());
+    MinkowskiDifferenceSupport support(first, second);
+    simplex.clear();
+
+    Vector2D direction = first[0] - second[0];
+    if (direction == Vector2D()) {
+        direction = Vector2D(1, 0);
+    }
+    simplex.push_back(support(direction));
+    direction = -simplex[0];
+    if (direction == Vector2D()) {
+        return true;
+    }
+
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        Vector2D a = support(direction);
+        if (a.dot(direction) < 0) {
+            return false;               //the difference has no point past the origin
+        }
+        simplex.push_back(a);
+        Vector2D to_origin = -a;
+
+        if (simplex.size() == 2) {
+            Vector2D ab = simplex[0] - a;
+            if (ab.cross_z(to_origin) == 0) {
+                return true;            //a is past the origin from simplex[0], so the origin is on the segment
+            }
+            direction = perpendicular_towards(ab, to_origin);
+            continue;
+        }
+
+        Vector2D b = simplex[1], c = simplex[0];
+        Vector2D ab = b - a, ac = c - a;
+        Vector2D ab_normal = perpendicular_towards(ab, -ac);
+        Vector2D ac_normal = perpendicular_towards(ac, -ab);
+        if (ab_normal.dot(to_origin) > 0) {
+            simplex = {b, a};
+            direction = ab_normal;
+        }
+        else if (ac_normal.dot(to_origin) > 0) {
+            simplex = {c, a};
+            direction = ac_normal;
+        }
+        else {
+            return true;
+        }
+    }
+    return minkowski_intersect(first, second);     //cycling on rounding errors, near the border
+}
+
+inline bool gjk_intersect(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second) {
+    std::vector<Vector2D> simplex;
+    return !first.empty() && !second.empty() && gjk(first, second, simplex);
+}
+
+// EPA: grows the GJK triangle inside the difference towards its border, always pushing
+// out the edge closest to the origin, until that edge is on the border.
+inline CollisionResult gjk_epa(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second) {
+    const double tolerance = 1e-10;
+    const int max_iterations = 64 + 2 * (first.size() + second.size());
+    CollisionResult result;
+    std::vector<Vector2D> polytope;
+    if (first.empty() || second.empty() || !gjk(first, second, polytope)) {
+        return result;
+    }
+    result.intersect = true;
+    MinkowskiDifferenceSupport support(first, second);
+
+    //turn a degenerate simplex into a triangle if the difference has any area
+    if (polytope.size() == 1) {
+        for (const Vector2D &direction : {Vector2D(1, 0), Vector2D(-1, 0), Vector2D(0, 1), Vector2D(0, -1)}) {
+            Vector2D point = support(direction);
+            if (!(point == polytope[0])) {
+                polytope.push_back(point);
+                break;
+            }
+        }
+    }
+    if (polytope.size() == 2) {
+        Vector2D edge = polytope[1] - polytope[0];
+        Vector2D normal(-edge.y(), edge.x());
+        for (const Vector2D &direction : {normal, -normal}) {
+            Vector2D point = support(direction);
+            if (edge.cross_z(point - polytope[0]) != 0) {
+                polytope.push_back(point);
+                break;
+            }
+        }
+    }
+    if (polytope.size() < 3) {
+        return result;                  //the difference is flat: the polygons only touch
+    }
+    if ((polytope[1] - polytope[0]).cross_z(polytope[2] - polytope[0]) < 0) {
+        std::swap(polytope[1], polytope[2]);
+    }
+
+    for (int iteration = 0; iteration < max_iterations; ++iteration) {
+        size_t closest = 0;
+        double closest_distance = INFINITY;
+        Vector2D closest_normal;
+        for (size_t i = 0; i < polytope.size(); ++i) {
+            Vector2D edge = polytope[i + 1 == polytope.size() ? 0 : i + 1] - polytope[i];
+            Vector2D normal(edge.y(), -edge.x());         //outward for a counter-clockwise polytope
+            double length = sqrt(normal.dot(normal));
+            if (length == 0) {
+                continue;
+            }
+            normal /= length;
+            double distance = normal.dot(polytope[i]);
+            if (distance < closest_distance) {
+                closest = i;
+                closest_distance = distance;
+                closest_normal = normal;
+            }
+        }
+        Vector2D point = support(closest_normal);
+        if (point.dot(closest_normal) - closest_distance <= tolerance * (1 + fabs(closest_distance))) {
+            result.depth = std::max(closest_distance, 0.);
+            result.normal = closest_normal;
+            return result;
+        }
+        polytope.insert(polytope.begin() + closest + 1, point);
+    }
+    return result;
+}
+
+// Intersection of polygons[pairs[i].first] and polygons[pairs[i].second] for every i.
+inline std::vector<char> gjk_intersect_batch(const std::vector<std::vector<Vector2D>> &polygons,
+                                             const std::vector<std::pair<size_t, size_t>> &pairs, size_t threads = 1) {
+    std::vector<char> result(pairs.size());
+    splitBetweenThreads(pairs.size(), threads, [&](size_t from, size_t to) {
+        std::vector<Vector2D> simplex;
+        for (size_t i = from; i < to; ++i) {
+            const auto &first = polygons[pairs[i].first], &second = polygons[pairs[i].second];
+            result[i] = !first.empty() && !second.empty() && gjk(first, second, simplex);
+        }
+    });
+    return result;
+}
+
+inline std::vector<CollisionResult> gjk_epa_batch(const std::vector<std::vector<Vector2D>> &polygons,
+                                                  const std::vector<std::pair<size_t, size_t>> &pairs,
+                                                  size_t threads = 1) {
+    std::vector<CollisionResult> result(pairs.size());
+    splitBetweenThreads(pairs.size(), threads, [&](size_t from, size_t to) {
+        for (size_t i = from; i < to; ++i) {
+            result[i] = gjk_epa(polygons[pairs[i].first], polygons[pairs[i].second]);
+        }
+    });
+    return result;
+}
@@ -0,0 +1,151 @@
+#pragma once
+
+#include <vector>
+#include "../task_0/Primitives2D.h"
+#include "../task_0/Predicates2D.h"
+#include "ConvexPolygon.h"
+
+// Minkowski sum of convex counter-clockwise polygons by merging their edges in polar
+// order, and the exact intersection test built on it.
+
+// Scratch buffers of minkowski_sum_into. They keep their capacity between calls,
+// so computing many sums of similar size doesn't allocate after the first one.
+struct MinkowskiWorkspace {
+    std::vector<Vector2D> first_points;
+    std::vector<Vector2D> second_points;
+    std::vector<Vector2D> first_edges;
+    std::vector<Vector2D> second_edges;
+};
+
+// The polygon itself if no two neighbouring vertices are equal, otherwise a copy in
+// buffer without the repeats; n becomes the new vertex count. A zero edge has no
+// direction, so the merge must never see one.
+inline const Vector2D *drop_repeated_vertices(const Vector2D *polygon, size_t &n, std::vector<Vector2D> &buffer) {
+    size_t k = 0;
+    while (k < n && !(polygon[k] == polygon[k + 1 == n ? 0 : k + 1])) {
+        ++k;
+    }
+    if (k == n || n == 1) {
+        return polygon;
+    }
+    buffer.clear();
+    for (size_t i = 0; i < n; ++i) {
+        if (buffer.empty() || !(buffer.back() == polygon[i])) {
+            buffer.push_back(polygon[i]);
+        }
+    }
+    while (buffer.size() > 1 && buffer.back() == buffer.front()) {
+        buffer.pop_back();
+    }
+    n = buffer.size();
+    return buffer.data();
+}
+
+// Edges of the polygon in order starting from its lowest vertex.
+inline void fill_edges(const Vector2D *polygon, size_t n, size_t offset, std::vector<Vector2D> &edges) {
+    edges.resize(n);
+    for (size_t k = 0, i = offset; k < n; ++k) {
+        size_t next = i + 1 == n ? 0 : i + 1;
+        edges[k] = polygon[next] - polygon[i];
+        i = next;
+    }
+}
+
+// Same as minkowski_sum, but rotates both polygons to their lowest vertex once,
+// precomputes the edge vectors and writes into a caller-provided buffer. Parallel
+// edges of the two polygons are merged, and so are collinear edges within one
+// polygon, so the result has no collinear vertices. The polygons are given as arrays, so
+// that they can stay where they are, e.g. in a MappedArray.
+inline void minkowski_sum_into(const Vector2D *first, size_t n, const Vector2D *second, size_t m,
+                               std::vector<Vector2D> &result, MinkowskiWorkspace &workspace) {
+    result.clear();
+    if (!n || !m) {
+        return;
+    }
+    first = drop_repeated_vertices(first, n, workspace.first_points);
+    second = drop_repeated_vertices(second, m, workspace.second_points);
+    const size_t first_offset = lowest_vertex(first, n);
+    const size_t second_offset = lowest_vertex(second, m);
+    fill_edges(first, n, first_offset, workspace.first_edges);
+    fill_edges(second, m, second_offset, workspace.second_edges);
+    const Vector2D *first_edges = workspace.first_edges.data();
+    const Vector2D *second_edges = workspace.second_edges.data();
+
+    //vertex k after the lowest one and edge k from it, of the first polygon (0) or the second (1)
+    auto vertex = [&](int polygon, size_t k) -> const Vector2D & {
+        const Vector2D *points = polygon ? second : first;
+        size_t size = polygon ? m : n, index = (polygon ? second_offset : first_offset) + k;
+        return points[index >= size ? index - size : index];
+    };
+    auto edge = [&](int polygon, size_t k) -> const Vector2D & {
+        return polygon ? second_edges[k] : first_edges[k];
+    };
+    auto half = [](const Vector2D &a) {
+        return int(a.y() < 0 || (a.y() == 0 && a.x() < 0));
+    };
+    //exact sign of the cross product of two edges, going back to the endpoints only if the filter fails
+    auto edge_cross_sign = [&](int p, size_t k, int q, size_t l) {
+        int sign;
+        if (!filteredCrossSign(edge(p, k), edge(q, l), sign)) {
+            sign = crossSign(vertex(p, k), vertex(p, k + 1), vertex(q, l), vertex(q, l + 1));
+        }
+        return sign;
+    };
+    //exact order of two edges by polar angle
+    auto first_not_after_second = [&](size_t i, size_t j) {
+        int a_half = half(first_edges[i]), b_half = half(second_edges[j]);
+        if (a_half != b_half)
+            return a_half < b_half ? 1 : -1;
+        return edge_cross_sign(0, i, 1, j);
+    };
+    auto same_direction = [&](int p, size_t k, int q, size_t l) {
+        return half(edge(p, k)) == half(edge(q, l)) && edge_cross_sign(p, k, q, l) == 0;
+    };
+
+    //every vertex is a sum of two input points, not of the edges walked so far, so no error
+    //piles up along the boundary; collinear vertices are dropped by the exact signs of the
+    //input edges that lead into and out of them
+    result.reserve(n + m);
+    result.push_back(vertex(0, 0) + vertex(1, 0));
+    size_t i = n == 1, j = m == 1;              //a single point has no edge to walk
+    int last_polygon = -1, closing_polygon = -1;  //the edges into result.back() and into the start
+    size_t last_edge = 0, closing_edge = 0;
+    while (i < n || j < m) {
+        int order = i == n ? -1 : j == m ? 1 : first_not_after_second(i, j);
+        int polygon = order >= 0 ? 0 : 1;
+        size_t step = order >= 0 ? i : j;
+        if (order >= 0) {
+            ++i;
+        }
+        if (order <= 0) {
+            ++j;
+        }
+        if (i == n && j == m) {
+            closing_polygon = polygon;          //back at the starting vertex
+            closing_edge = step;
+            break;
+        }
+        Vector2D current = vertex(0, i) + vertex(1, j);
+        if (last_polygon >= 0 && same_direction(last_polygon, last_edge, polygon, step)) {
+            result.back() = current;
+        }
+        else {
+            result.push_back(current);
+        }
+        last_polygon = polygon;
+        last_edge = step;
+    }
+    if (result.size() >= 3 && closing_polygon >= 0
+        && same_direction(last_polygon, last_edge, closing_polygon, closing_edge)) {
+        result.pop_back();
+    }
+}
+
+inline void minkowski_sum_into(const std::vector<Vector2D> &first, const std::vector<Vector2D> &second,
+                               std::vector<Vector2D> &result, MinkowskiWorkspace &workspace) {
+    minkowski_sum_into(first.data(), first.size(), second.data(), second.size(), result, workspace);
+}
+
+inline bool zero_in_polygon(const std::vector<Vector2D> &polygon) {
+    return ConvexPolygon(polygon).contains(Point2D());
+}
@@ -1,47 +1,41 @@
 #include <iostream>
 #include <vector>
 #include <cmath>
+#include <iomanip>
+#include <string>
+#include <random>
+#include <chrono>
 #include "../task_0/Primitives2D.h"
+#include "../task_0/Predicates2D.h"
+#include "ConvexPolygon.h"
+#include "Minkowski.h"
+#include "Gjk.h"
+#include "ConvexHull.h"
+#include "../task_0/GeometryIO.h"
 
 using std::vector;
 
-double eps = 1e-32;
-
-bool operator<(Vector2D a, Vector2D b) {
-    if (a.y() > eps && b.y() < -eps)
-        return true;
+// Polar angle half of an edge: 0 for angles in [0, pi), 1 for [pi, 2 pi).
+// The sign of a difference of two doubles is always exact.
+int angle_half(const Point2D &from, const Point2D &to) {
+    return to.y() < from.y() || (to.y() == from.y() && to.x() < from.x());
+}
 
-    if (a.y() < -eps && b.y() > eps)
-        return false;
+// Whether the polar angle of edge p0 -> p1 does not exceed the one of edge q0 -> q1.
+bool edge_not_after(const Point2D &p0, const Point2D &p1, const Point2D &q0, const Point2D &q1) {
+    int p_half = angle_half(p0, p1);
+    int q_half = angle_half(q0, q1);
+    if (p_half != q_half)
+        return p_half < q_half;
 
-    return a.cross_z(b) > -eps;
+    return crossSign(p0, p1, q0, q1) >= 0;
 }
 
 vector<Vector2D> minkowski_sum(const vector<Vector2D> &first, const vector<Vector2D> &second) {
     vector<Vector2D> result;
 
-    size_t first_offset = 0;
-    for (size_t i = 1; i < first.size(); ++i) {
-        auto cur = first[i];
-        auto prev = first[first_offset];
-        if (cur.x() < prev.x()) {
-            first_offset = i;
-        }
-        if (cur.x() == prev.x() && cur.y() < prev.y()) {
-            first_offset = i;
-        }
-    }
-    size_t second_offset = 0;
-    for (size_t i = 1; i < second.size(); ++i) {
-        auto cur = second[i];
-        auto prev = second[second_offset];
-        if (cur.x() < prev.x()) {
-            second_offset = i;
-        }
-        if (cur.x() == prev.x() && cur.y() < prev.y()) {
-            second_offset = i;
-        }
-    }
+    size_t first_offset = lowest_vertex(first);
+    size_t second_offset = lowest_vertex(second);
 
     size_t i = first_offset;
     size_t j = second_offset;
@@ -53,43 +47,345 @@ vector<Vector2D> minkowski_sum(const vector<Vector2D> &first, const vector<Vecto
 
         result.push_back(first_i + second_j);
 
-        if (first_i_1 - first_i < second_j_1 - second_j) {
-            ++j;
+        bool first_done = i == first.size() + first_offset;
+        bool second_done = j == second.size() + second_offset;
+        bool advance_first = second_done || (!first_done && edge_not_after(first_i, first_i_1, second_j, second_j_1));
+        bool advance_second = first_done || (!second_done && edge_not_after(second_j, second_j_1, first_i, first_i_1));
+        i += advance_first;
+        j += advance_second;
+    }
+    return result;
+}
+
+// Regular polygon with a random rotation, radius and center.
+vector<Vector2D> random_convex_polygon(size_t vertices, std::mt19937_64 &rd) {
+    std::uniform_real_distribution<double> ds_unit(0, 1);
+    double rotation = ds_unit(rd) * 2 * M_PI, radius = 1 + ds_unit(rd), x = ds_unit(rd), y = ds_unit(rd);
+    vector<Vector2D> polygon;
+    for (size_t i = 0; i < vertices; ++i) {
+        double angle = rotation + 2 * M_PI * i / vertices;
+        polygon.emplace_back(x + radius * cos(angle), y + radius * sin(angle));
+    }
+    return polygon;
+}
+
+void benchmark_minkowski(size_t sums) {
+    const size_t polygons = 1000;
+    std::mt19937_64 rd(sums);
+    vector<vector<Vector2D>> inputs;
+    for (size_t i = 0; i < polygons; ++i) {
+        inputs.push_back(random_convex_polygon(3 + rd() % 14, rd));
+    }
+
+    auto time_start = std::chrono::steady_clock::now();
+    size_t checksum = 0;
+    for (size_t i = 0; i < sums; ++i) {
+        checksum += minkowski_sum(inputs[i % polygons], inputs[(i * 7 + 1) % polygons]).size();
+    }
+    auto time_end = std::chrono::steady_clock::now();
+    long long naive_time = (time_end - time_start).count();
+
+    time_start = std::chrono::steady_clock::now();
+    vector<Vector2D> result;
+    MinkowskiWorkspace workspace;
+    for (size_t i = 0; i < sums; ++i) {
+        minkowski_sum_into(inputs[i % polygons], inputs[(i * 7 + 1) % polygons], result, workspace);
+        checksum -= result.size();
+    }
+    time_end = std::chrono::steady_clock::now();
+    long long into_time = (time_end - time_start).count();
+
+    std::cout << std::setw(22) << std::left << "Time, ns per sum" << '\n';
+    std::cout << std::setw(22) << "minkowski_sum" << naive_time / sums << '\n';
+    std::cout << std::setw(22) << "minkowski_sum_into" << into_time / sums << '\n';
+    std::cout << "(vertex count difference " << checksum << ")" << '\n';
+
+    vector<std::pair<size_t, size_t>> pairs;
+    for (size_t i = 0; i < sums; ++i) {
+        pairs.emplace_back(i % polygons, (i * 7 + 1) % polygons);
+    }
+    time_start = std::chrono::steady_clock::now();
+    size_t intersections = 0;
+    vector<Vector2D> negated;
+    for (const auto &pair : pairs) {
+        negated.clear();
+        for (const auto &vertex : inputs[pair.second]) {
+            negated.push_back(-vertex);
         }
-        if (second_j_1 - second_j < first_i_1 - first_i) {
-            ++i;
+        minkowski_sum_into(inputs[pair.first], negated, result, workspace);
+        intersections += zero_in_polygon(result);
+    }
+    time_end = std::chrono::steady_clock::now();
+    long long minkowski_time = (time_end - time_start).count();
+
+    time_start = std::chrono::steady_clock::now();
+    auto gjk_result = gjk_intersect_batch(inputs, pairs, std::max(1u, std::thread::hardware_concurrency()));
+    time_end = std::chrono::steady_clock::now();
+    long long gjk_time = (time_end - time_start).count();
+    for (char intersect : gjk_result) {
+        intersections -= intersect;
+    }
+
+    std::cout << std::setw(22) << "Intersection test" << '\n';
+    std::cout << std::setw(22) << "minkowski difference" << minkowski_time / sums << '\n';
+    std::cout << std::setw(22) << "gjk batch" << gjk_time / sums << '\n';
+    std::cout << "(answer difference " << intersections << ")" << '\n';
+}
+
+// Axis-aligned rectangle with integer corners, counter-clockwise from a random vertex,
+// with extra points on its edges: collinear vertices GJK must cope with.
+vector<Vector2D> random_rectangle_with_edge_points(std::mt19937_64 &rd) {
+    std::uniform_int_distribution<int> ds_coordinate(0, 8);
+    int x0 = ds_coordinate(rd), x1 = ds_coordinate(rd), y0 = ds_coordinate(rd), y1 = ds_coordinate(rd);
+    if (x0 > x1) {
+        std::swap(x0, x1);
+    }
+    if (y0 > y1) {
+        std::swap(y0, y1);
+    }
+    x1 += 1;
+    y1 += 1;
+    //scaled so that the points dividing an edge in halves and thirds are integer
+    vector<Vector2D> corners = {Vector2D(6 * x0, 6 * y0), Vector2D(6 * x1, 6 * y0),
+                                Vector2D(6 * x1, 6 * y1), Vector2D(6 * x0, 6 * y1)};
+    vector<Vector2D> polygon;
+    for (size_t k = 0; k < 4; ++k) {
+        polygon.push_back(corners[k]);
+        Vector2D edge = corners[(k + 1) % 4] - corners[k];
+        size_t extra = rd() % 3;
+        for (size_t e = 1; e <= extra; ++e) {
+            polygon.push_back(corners[k] + edge * (double)e / (extra + 1));
         }
     }
-    return result;
+    std::rotate(polygon.begin(), polygon.begin() + rd() % polygon.size(), polygon.end());
+    return polygon;
+}
+
+// Regression check of GJK against the exact Minkowski difference test on polygons with
+// collinear vertices. Returns the number of mismatches.
+size_t check_gjk(size_t count) {
+    size_t mismatches = 0;
+    vector<Vector2D> square = {Vector2D(1, 0), Vector2D(2, 0), Vector2D(2, 2), Vector2D(0, 2), Vector2D(0, 0)};
+    mismatches += support_index(square, Vector2D(0, 1), 0) != 2;
+    vector<Vector2D> a = {Vector2D(3, 5), Vector2D(5, 5), Vector2D(7, 5), Vector2D(7, 7), Vector2D(3, 7)};
+    vector<Vector2D> b = {Vector2D(0, 5), Vector2D(5, 5), Vector2D(5, 6), Vector2D(0, 6)};
+    mismatches += !gjk_intersect(a, b);
+
+    std::mt19937_64 rd(count);
+    for (size_t i = 0; i < count; ++i) {
+        vector<Vector2D> first = random_rectangle_with_edge_points(rd);
+        vector<Vector2D> second = random_rectangle_with_edge_points(rd);
+        mismatches += gjk_intersect(first, second) != minkowski_intersect(first, second);
+    }
+    std::cout << "GJK mismatches: " << mismatches << '\n';
+    return mismatches;
+}
+
+// Convex polygon with integer vertices, some of them repeated, counter-clockwise from a
+// random vertex.
+vector<Vector2D> random_polygon_with_repeats(std::mt19937_64 &rd) {
+    std::uniform_int_distribution<int> ds_coordinate(0, 16);
+    vector<Vector2D> points(1 + rd() % 8);
+    for (auto &point : points) {
+        point = Vector2D(ds_coordinate(rd), ds_coordinate(rd));
+    }
+    vector<Vector2D> polygon;
+    for (const auto &vertex : convex_hull(points)) {
+        polygon.insert(polygon.end(), 1 + rd() % 3 / 2, vertex);
+    }
+    std::rotate(polygon.begin(), polygon.begin() + rd() % polygon.size(), polygon.end());
+    return polygon;
 }
 
-bool zero_in_polygon(const vector<Vector2D> &polygon) {
-    for (size_t i = 2; i < polygon.size(); ++i) {
-        if ((polygon[i] - polygon[0] < -polygon[0]) && (-polygon[0] < polygon[i - 1] - polygon[0])) {
-            return polygon[i + 1].cross_z(polygon[i]) > -eps;
+// Checks minkowski_sum_into against the hull of all pairwise sums of vertices, on
+// polygons with repeated vertices. Both are compared from their lexicographically
+// smallest vertex. Returns the number of mismatches.
+size_t check_minkowski(size_t count) {
+    MinkowskiWorkspace workspace;
+    auto mismatch = [&](const vector<Vector2D> &first, const vector<Vector2D> &second) {
+        vector<Vector2D> sums, result;
+        for (const auto &a : first) {
+            for (const auto &b : second) {
+                sums.push_back(a + b);
+            }
         }
+        vector<Vector2D> expected = convex_hull(sums);
+        minkowski_sum_into(first, second, result, workspace);
+        if (!result.empty()) {
+            std::rotate(result.begin(), std::min_element(result.begin(), result.end(), lexicographically_less),
+                        result.end());
+        }
+        return result != expected;
+    };
+
+    size_t mismatches = 0;
+    mismatches += mismatch({Vector2D(4, 0), Vector2D(16, 10), Vector2D(16, 10), Vector2D(2, 4)},
+                           {Vector2D(6, 10), Vector2D(0, 16), Vector2D(2, 6)});
+    std::mt19937_64 rd(count);
+    for (size_t i = 0; i < count; ++i) {
+        mismatches += mismatch(random_polygon_with_repeats(rd), random_polygon_with_repeats(rd));
     }
-    return false;
+    std::cout << "Minkowski sum mismatches: " << mismatches << '\n';
+    return mismatches;
 }
 
-int main() {
-    size_t n, m;
+// Checks ConvexPolygon::contains against the edge tests of the hull, on polygons with
+// repeated vertices and vertices in the middle of edges. Returns the number of mismatches.
+size_t check_convex_polygon(size_t count) {
+    ConvexPolygon example({Vector2D(8, 16), Vector2D(0, 12), Vector2D(0, 7), Vector2D(0, 2), Vector2D(16, 6)});
+    size_t mismatches = example.contains(Point2D(0, 18));
+
+    std::mt19937_64 rd(count);
+    std::uniform_int_distribution<int> ds_coordinate(-2, 34);
+    for (size_t i = 0; i < count; ++i) {
+        vector<Vector2D> hull = random_polygon_with_repeats(rd);
+        hull.erase(std::unique(hull.begin(), hull.end()), hull.end());
+        while (hull.size() > 1 && hull.back() == hull.front()) {
+            hull.pop_back();
+        }
+        if (hull.size() < 3) {
+            continue;
+        }
+        vector<Vector2D> polygon;
+        for (size_t k = 0; k < hull.size(); ++k) {
+            polygon.push_back(hull[k] * 2);
+            if (rd() % 2) {
+                polygon.push_back(hull[k] + hull[(k + 1) % hull.size()]);
+            }
+        }
+        ConvexPolygon convex(polygon);
+        for (size_t q = 0; q < 20; ++q) {
+            Point2D point(ds_coordinate(rd), ds_coordinate(rd));
+            bool inside = true;
+            for (size_t k = 0; k < hull.size(); ++k) {
+                inside = inside && orientation(hull[k] * 2, hull[(k + 1) % hull.size()] * 2, point) >= 0;
+            }
+            mismatches += convex.contains(point) != inside;
+        }
+    }
+    std::cout << "Convex polygon mismatches: " << mismatches << '\n';
+    return mismatches;
+}
+
+void benchmark_hull(size_t size) {
+    std::mt19937_64 rd(size);
+    std::normal_distribution<double> ds_coordinate(0, 1000);
     vector<Vector2D> first, second;
-    std::cin >> n;
+    for (size_t i = 0; i < size; ++i) {
+        first.emplace_back(ds_coordinate(rd), ds_coordinate(rd));
+        second.emplace_back(ds_coordinate(rd) + 3000, ds_coordinate(rd));
+    }
+    size_t threads = std::max(1u, std::thread::hardware_concurrency());
+
+    auto time_start = std::chrono::steady_clock::now();
+    vector<Vector2D> sorted = first;
+    std::sort(sorted.begin(), sorted.end(), lexicographically_less);
+    sorted.erase(std::unique(sorted.begin(), sorted.end()), sorted.end());
+    auto plain_hull = monotone_chain(sorted);
+    auto time_end = std::chrono::steady_clock::now();
+    long long plain_time = (time_end - time_start).count();
+
+    time_start = std::chrono::steady_clock::now();
+    auto first_hull = convex_hull(first, threads);
+    time_end = std::chrono::steady_clock::now();
+    long long hull_time = (time_end - time_start).count();
+
+    auto second_hull = convex_hull(second, threads);
+    for (auto &vertex : second_hull) {
+        vertex = -vertex;
+    }
+    vector<Vector2D> difference;
+    MinkowskiWorkspace workspace;
+    minkowski_sum_into(first_hull, second_hull, difference, workspace);
+
+    std::cout << std::left << "Hull of " << size << " points, ms" << '\n';
+    std::cout << std::setw(34) << "sort + monotone chain" << plain_time / 1000000 << '\n';
+    std::cout << std::setw(34) << "filter + parallel sort + chain" << hull_time / 1000000 << '\n';
+    std::cout << "Hull sizes " << plain_hull.size() << ' ' << first_hull.size()
+              << ", clouds intersect: " << (zero_in_polygon(difference) ? "YES" : "NO") << '\n';
+}
+
+const char POLYGON_TAG[] = "POLY2D";
+
+// Prints the Minkowski sum of the first polygon and the reflected second one
+// followed by whether they intersect.
+void print_answer(const Vector2D *first, size_t n, const Vector2D *second, size_t m) {
+    vector<Vector2D> minkowski;
+    MinkowskiWorkspace workspace;
+    minkowski_sum_into(first, n, second, m, minkowski, workspace);
+    FastOutput output;
+    for (auto a : minkowski) {
+        output.write(a.x());
+        output.write(' ');
+        output.write(a.y());
+        output.write('\n');
+    }
+    output.write(zero_in_polygon(minkowski) ? "YES" : "NO");
+}
+
+void print_answer(const vector<Vector2D> &first, const vector<Vector2D> &second) {
+    print_answer(first.data(), first.size(), second.data(), second.size());
+}
+
+bool read_polygon(FastInput &input, vector<Vector2D> &polygon, double sign) {
+    size_t n;
+    if (!input.read(n)) {
+        return false;
+    }
+    polygon.clear();
+    polygon.reserve(std::min<size_t>(n, 1 << 20));  //a malformed count must not allocate it all
     for (size_t i = 0; i < n; ++i) {
         double x, y;
-        std::cin >> x >> y;
-        first.emplace_back(x, y);
+        if (!input.read(x) || !input.read(y)) {
+            return false;
+        }
+        polygon.emplace_back(sign * x, sign * y);
     }
-    std::cin >> m;
-    for (size_t i = 0; i < m; ++i) {
-        double x, y;
-        std::cin >> x >> y;
-        second.emplace_back(-x, -y);
+    return true;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && std::string(argv[1]) == "--benchmark-hull") {
+        benchmark_hull(argc > 2 ? std::stoull(argv[2]) : 10000000);
+        return 0;
     }
-    auto minkowski = minkowski_sum(first, second);
-    for (auto a : minkowski) {
-        std::cout << a.x() << ' ' << a.y() << '\n';
+    if (argc > 1 && std::string(argv[1]) == "--check-minkowski") {
+        return check_minkowski(argc > 2 ? std::stoull(argv[2]) : 200000) != 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check-polygon") {
+        return check_convex_polygon(argc > 2 ? std::stoull(argv[2]) : 200000) != 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--check-gjk") {
+        return check_gjk(argc > 2 ? std::stoull(argv[2]) : 200000) != 0;
+    }
+    if (argc > 1 && std::string(argv[1]) == "--benchmark") {
+        benchmark_minkowski(argc > 2 ? std::stoull(argv[2]) : 1000000);
+        return 0;
+    }
+    if (argc > 3 && std::string(argv[1]) == "--generate-binary") {
+        std::mt19937_64 rd(std::stoull(argv[3]));
+        return !writeBinaryArray(argv[2], POLYGON_TAG, random_convex_polygon(std::stoull(argv[3]), rd));
+    }
+    if (argc > 3 && std::string(argv[1]) == "--binary") {
+        MappedArray<Vector2D> first, second;
+        if (!first.open(argv[2], POLYGON_TAG) || !second.open(argv[3], POLYGON_TAG)) {
+            std::cerr << "Can't read binary polygon files" << '\n';
+            return 1;
+        }
+        vector<Vector2D> reflected;
+        reflected.reserve(second.size());
+        for (const auto &a : second) {
+            reflected.push_back(-a);
+        }
+        print_answer(first.data(), first.size(), reflected.data(), reflected.size());
+        return 0;
+    }
+
+    FastInput input;
+    vector<Vector2D> first, second;
+    if (!read_polygon(input, first, 1) || !read_polygon(input, second, -1)) {
+        std::cerr << "Expected two polygons, each as a vertex count and its coordinates" << '\n';
+        return 1;
     }
-    std::cout << (zero_in_polygon(minkowski) ? "YES" : "NO");
+    print_answer(first, second);
 }
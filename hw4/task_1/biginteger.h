@@ -1,431 +1,1389 @@
-#include <iostream>
-#include <vector>
-#include <string>
-#include <sstream>
-
-class BigInteger {
-
-private:
-
-    std::vector<long long> digits_;
-    bool negative_;
-    static const char base_len_ = 3;
-    static const long base_ = 1e+3;
-
-    bool isNegative() const;
-    bool isZero() const;
-
-    void normalize();
-    void add(const BigInteger &a, bool substract = 0, bool invert = 0);
-    void divide(const BigInteger &divisor, bool modulo = 0);
-    BigInteger &karatsubaMultiply(const BigInteger &other);
-    template<typename InputIterator>
-    BigInteger(InputIterator first, InputIterator last);
-
-public:
-
-    BigInteger();
-
-    ~BigInteger() = default;
-    BigInteger(const BigInteger &other) = default;
-    BigInteger(BigInteger &&other) = default;
-    explicit BigInteger(const std::string &string);
-
-    BigInteger(long long value);
-    BigInteger &operator=(const BigInteger &other) = default;
-
-    BigInteger &operator=(BigInteger &&other) = default;
-    std::string toString() const;
-
-    size_t getSize() const;
-
-    char getBaseLength() const;
-    long long int getDigit(size_t pos) const;
-    const BigInteger operator-() const;
-
-    BigInteger &operator++();
-
-    BigInteger &operator--();
-    const BigInteger operator++(int);
-
-    const BigInteger operator--(int);
-    BigInteger &operator+=(const BigInteger &a);
-
-    BigInteger &naiveMultiply(const BigInteger &other);
-    BigInteger &operator-=(const BigInteger &a);
-    BigInteger &operator*=(const BigInteger &a);
-    BigInteger &operator/=(const BigInteger &a);
-    BigInteger &operator%=(const BigInteger &a);
-
-    int compare(const BigInteger &other) const;
-
-    explicit operator bool() const;
-
-    friend std::istream &operator>>(std::istream &is, BigInteger &a);
-
-};
-
-std::ostream &operator<<(std::ostream &os, const BigInteger &a);
-
-const BigInteger operator+(const BigInteger &a, const BigInteger &b);
-const BigInteger operator-(const BigInteger &a, const BigInteger &b);
-const BigInteger operator*(const BigInteger &a, const BigInteger &b);
-const BigInteger operator/(const BigInteger &a, const BigInteger &b);
-const BigInteger operator%(const BigInteger &a, const BigInteger &b);
-
-bool operator>(const BigInteger &a, const BigInteger &b);
-bool operator<(const BigInteger &a, const BigInteger &b);
-bool operator>=(const BigInteger &a, const BigInteger &b);
-bool operator<=(const BigInteger &a, const BigInteger &b);
-bool operator==(const BigInteger &a, const BigInteger &b);
-bool operator!=(const BigInteger &a, const BigInteger &b);
-
-
-BigInteger::BigInteger() : digits_({0}), negative_(0) {}
-
-BigInteger::BigInteger(const long long int value) : digits_({value}), negative_(value < 0) {
-    if (digits_[0] < 0) {
-        digits_[0] *= -1;
-    }
-    for (size_t i = 0; digits_[i] >= base_; ++i) {
-        digits_.push_back(digits_[i] / base_);
-        digits_[i] %= base_;
-    }
-}
-
-BigInteger::BigInteger(const std::string &string) {
-    negative_ = (string[0] == '-');
-
-    long long digit = 0, multiplier = 1;
-    for (auto it = string.rbegin(); it != string.rend() - negative_; ++it) {
-        digit += multiplier * (*it - '0');
-        multiplier *= 10;
-        if (multiplier >= base_) {
-            digits_.push_back(digit);
-            digit = 0;
-            multiplier = 1;
-        }
-    }
-    if (digit || !getSize())
-        digits_.push_back(digit);
-
-    normalize();
-}
-
-size_t BigInteger::getSize() const {
-    return digits_.size();
-}
-
-char BigInteger::getBaseLength() const {
-    return base_len_;
-}
-
-long long int BigInteger::getDigit(size_t pos) const {
-    return pos < digits_.size() ? digits_[pos] : 0;
-}
-
-bool BigInteger::isNegative() const {
-    return negative_;
-}
-
-bool BigInteger::isZero() const {
-    return getSize() == 1 && digits_[0] == 0;
-}
-
-
-void BigInteger::normalize() {
-    while (getSize() > 1 && digits_[getSize() - 1] == 0)
-        digits_.pop_back();
-    if (getSize() == 1 && digits_[0] == 0) {
-        negative_ = 0;
-    }
-}
-
-void BigInteger::add(const BigInteger &a, const bool substract, const bool invert) {
-    for (size_t i = 0; i < a.getSize(); ++i) {
-        if (i == getSize())
-            digits_.push_back(0);
-        digits_[i] += a.digits_[i] * (2 * !substract - 1);
-        digits_[i] *= (2 * !invert - 1);
-    }
-
-    for (size_t i = 0; i < getSize(); ++i) {
-        if (digits_[i] < 0) {
-            --digits_[i + 1];
-            digits_[i] += base_;
-        }
-        else if (digits_[i] >= base_) {
-            if (i + 1 == getSize())
-                digits_.push_back(0);
-            ++digits_[i + 1];
-            digits_[i] -= base_;
-        }
-    }
-
-    negative_ = negative_ ^ invert;
-
-    normalize();
-}
-
-const BigInteger BigInteger::operator-() const {
-    BigInteger a = *this;
-    a.negative_ = !isZero() && !negative_;
-    return a;
-}
-
-BigInteger &BigInteger::operator++() {
-    *this += 1;
-    return *this;
-}
-
-BigInteger &BigInteger::operator--() {
-    *this -= 1;
-    return *this;
-}
-
-const BigInteger BigInteger::operator++(int) {
-    BigInteger a(*this);
-    *this += 1;
-    return a;
-}
-
-const BigInteger BigInteger::operator--(int) {
-    BigInteger a(*this);
-    *this -= 1;
-    return a;
-}
-
-BigInteger &BigInteger::operator+=(const BigInteger &a) {
-    if (negative_ == a.negative_)
-        add(a, 0, 0);
-    else if ((*this >= -a) != negative_)
-        add(a, 1, 0);
-    else
-        add(a, 1, 1);
-    return *this;
-}
-
-BigInteger &BigInteger::operator-=(const BigInteger &a) {
-    return *this += (-a);
-}
-
-BigInteger &BigInteger::operator*=(const BigInteger &a) {
-    return karatsubaMultiply(a);
-}
-
-BigInteger &BigInteger::operator/=(const BigInteger &a) {
-    if (a.isNegative())
-        divide(-a);
-    else
-        divide(a);
-    negative_ = !isZero() && (negative_ != a.negative_);
-    return *this;
-}
-
-BigInteger &BigInteger::operator%=(const BigInteger &a) {
-    if (a.isNegative())
-        divide(-a, 1);
-    else
-        divide(a, 1);
-    return *this;
-}
-
-void BigInteger::divide(const BigInteger &divisor, bool modulo) {
-    BigInteger quotient, remainder;
-
-    for (size_t i = digits_.size() - 1; i <= digits_.size() - 1; --i) {
-        remainder.digits_.insert(remainder.digits_.begin(), digits_[i]);
-        remainder.normalize();
-
-        quotient.digits_.insert(quotient.digits_.begin(), 0);
-        quotient.normalize();
-
-        while (divisor <= remainder) {
-            if (divisor.getSize() == 1) {
-                long long count = (remainder.getSize() != 1 ? base_ : remainder.getDigit(0)) / divisor.getDigit(0);
-                remainder -= count * divisor.getDigit(0);
-                quotient += count;
-            }
-            else {
-                ++quotient;
-                remainder -= divisor;
-            }
-        }
-    }
-
-    if (!modulo)
-        digits_ = quotient.digits_;
-    else
-        digits_ = remainder.digits_;
-
-    normalize();
-}
-
-std::ostream &operator<<(std::ostream &os, const BigInteger &a) {
-    if (a < 0)
-        os << '-';
-    os.fill('0');
-    for (size_t i = a.getSize(); i > 0; --i) {
-        if (i != a.getSize())
-            os.width(a.getBaseLength());
-        os << a.getDigit(i - 1);
-    }
-    return os;
-}
-
-std::istream &operator>>(std::istream &is, BigInteger &a) {
-    std::string input;
-    is >> input;
-    a = BigInteger(input);
-    return is;
-}
-
-const BigInteger operator+(const BigInteger &a, const BigInteger &b) {
-    BigInteger c = a;
-    c += b;
-    return c;
-}
-
-const BigInteger operator-(const BigInteger &a, const BigInteger &b) {
-    BigInteger c = a;
-    c -= b;
-    return c;
-}
-
-const BigInteger operator*(const BigInteger &a, const BigInteger &b) {
-    BigInteger c = a;
-    c *= b;
-    return c;
-}
-
-const BigInteger operator/(const BigInteger &a, const BigInteger &b) {
-    BigInteger c = a;
-    c /= b;
-    return c;
-}
-
-const BigInteger operator%(const BigInteger &a, const BigInteger &b) {
-    BigInteger c = a;
-    c %= b;
-    return c;
-}
-
-int BigInteger::compare(const BigInteger &other) const {
-    if (negative_ != other.negative_)
-        return other.negative_ ? 1 : -1;
-
-    bool invert = negative_;
-
-    if (getSize() != other.getSize())
-        return (getSize() > other.getSize()) != invert ? 1 : -1;
-
-    for (size_t i = getSize() - 1; i < getSize(); --i)
-        if (digits_[i] != other.digits_[i])
-            return (digits_[i] > other.digits_[i]) != invert ? 1 : -1;
-
-    return 0;
-}
-
-bool operator>(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) == 1;
-}
-
-bool operator<(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) == -1;
-}
-
-bool operator>=(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) >= 0;
-}
-
-bool operator<=(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) <= 0;
-}
-
-bool operator==(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) == 0;
-}
-
-bool operator!=(const BigInteger &a, const BigInteger &b) {
-    return a.compare(b) != 0;
-}
-
-BigInteger::operator bool() const {
-    return *this != 0;
-}
-
-std::string BigInteger::toString() const {
-    std::ostringstream output;
-    output << *this;
-    return output.str();
-}
-
-template<typename InputIterator>
-BigInteger::BigInteger(InputIterator first, InputIterator last) : digits_(first, last), negative_(0) {
-    normalize();
-}
-
-BigInteger &BigInteger::karatsubaMultiply(const BigInteger &other) {
-    size_t n = std::max(getSize(), other.getSize());
-    if (n <= 32) {
-        return naiveMultiply(other);
-    }
-
-    size_t k = n / 2;
-
-    BigInteger this_low = BigInteger(digits_.begin(),
-                                digits_.begin() + std::min(k, digits_.size()));
-    BigInteger this_high =
-            k < digits_.size()
-            ? BigInteger(digits_.begin() + k, digits_.end())
-            : BigInteger(0);
-    BigInteger other_low = BigInteger(other.digits_.begin(),
-                                other.digits_.begin() + std::min(k, other.digits_.size()));
-    BigInteger other_high =
-            k < other.digits_.size()
-            ? BigInteger(other.digits_.begin() + k, other.digits_.end())
-            : BigInteger(0);
-
-    BigInteger prod1(this_high);
-    prod1.karatsubaMultiply(other_high);
-
-    BigInteger prod2(this_low);
-    prod2.karatsubaMultiply(other_low);
-
-    BigInteger &prod3 = (this_high += this_low).karatsubaMultiply(other_high += other_low);
-
-    prod3 -= prod1;
-    prod3 -= prod2;
-    prod1.digits_.insert(prod1.digits_.begin(), (n / 2) * 2, 0);
-    prod3.digits_.insert(prod3.digits_.begin(), n / 2, 0);
-    prod1 += prod2;
-    prod1 += prod3;
-
-    prod1.negative_ = negative_ ^ other.negative_;
-
-    *this = prod1;
-    return *this;
-}
-
-BigInteger &BigInteger::naiveMultiply(const BigInteger &other) {
-    BigInteger c;
-    for (size_t i = 0; i < getSize(); ++i) {
-        long long carry = 0;
-        for (size_t j = 0; j < other.getSize() || carry; ++j) {
-            if (c.getSize() <= i + j)
-                c.digits_.push_back(0);
-
-            long long temp = c.digits_[i + j] + digits_[i] * other.getDigit(j) + carry;
-
-            c.digits_[i + j] = temp % base_;
-            carry = temp / base_;
-        }
-    }
-
-    c.normalize();
-
-    digits_ = c.digits_;
-    negative_ = !isZero() && (negative_ != other.negative_);
-
-    return *this;
-}
+#include <iostream>
+#include <vector>
+#include <string>
+#include <algorithm>
+#include <cstdint>
+#include <deque>
+#include <thread>
+#include <type_traits>
+#if defined(__x86_64__)
+#include <x86intrin.h>
+#endif
+#include "ntt.h"
+#include "limbvector.h"
+
+class BigInteger {
+
+private:
+
+    typedef uint64_t Limb;
+    typedef unsigned __int128 DoubleLimb;
+
+    LimbVector limbs_;                  //magnitude in base 2^64, least significant limb first, zero is empty
+    bool negative_;
+    static const int decimal_base_len_ = 19;
+    static const Limb decimal_base_ = 10000000000000000000ull;
+    //numbers up to this many limbs are converted to and from decimal limb by limb
+    static const size_t decimal_conversion_threshold_ = 32;
+
+    bool isNegative() const;
+    bool isZero() const;
+
+    void normalize();
+    void add(const BigInteger &a, bool substract = 0, bool invert = 0);
+    BigInteger &addSigned(const BigInteger &a, bool negative);
+    BigInteger &addLimb(Limb value, bool negative);
+    void divide(const BigInteger &divisor, bool modulo = 0);
+    Limb divideByLimb(Limb divisor);
+    BigInteger limbRange(size_t from, size_t to) const;
+    void shiftLeft(int bits);
+    void shiftRight(int bits);
+    void multiplyAddLimb(Limb multiplier, Limb addend);
+    BigInteger &multiply(const BigInteger &other);
+
+    static int compareMagnitudes(const LimbVector &a, const LimbVector &b);
+    static int compareLimbs(const Limb *a, const Limb *b, size_t n);
+
+    static unsigned char addWithCarry(unsigned char carry, Limb a, Limb b, Limb &sum);
+    static unsigned char subtractWithBorrow(unsigned char borrow, Limb a, Limb b, Limb &difference);
+    static Limb addTo(Limb *a, size_t n, const Limb *b, size_t m);
+    static Limb subtractFrom(Limb *a, size_t n, const Limb *b, size_t m);
+    static void subtractReversed(Limb *a, const Limb *b, size_t n);
+    static bool absoluteDifference(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result);
+    static void multiplyNaive(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result);
+    static size_t karatsubaScratchSize(size_t n);
+    template<typename First, typename Second, typename Third>
+    static void runInParallel(size_t threads, First first, Second second, Third third);
+    static void multiplyKaratsuba(const Limb *a, const Limb *b, size_t n, Limb *result, Limb *scratch,
+                                  size_t threads = 1);
+    static void squareNaive(const Limb *a, size_t n, Limb *result);
+    static void squareKaratsuba(const Limb *a, size_t n, Limb *result, Limb *scratch, size_t threads = 1);
+    static size_t multiplyScratchSize(size_t n, size_t m);
+    static void multiplyLimbs(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result, Limb *scratch,
+                              size_t threads = 1);
+
+    static BigInteger concatenate(const BigInteger &high, const BigInteger &low, size_t k);
+    static void divideKnuth(const Limb *u, size_t n, const Limb *v, size_t m, Limb *quotient, Limb *remainder);
+    static void divideSchoolbook(const BigInteger &a, const BigInteger &b, BigInteger &quotient, BigInteger &remainder);
+    static void divideTwoByOne(const BigInteger &a, const BigInteger &b, size_t n,
+                               BigInteger &quotient, BigInteger &remainder);
+    static void divideThreeByTwo(const BigInteger &a12, const BigInteger &a3, const BigInteger &b,
+                                 const BigInteger &b1, const BigInteger &b2, size_t n,
+                                 BigInteger &quotient, BigInteger &remainder);
+    static void divideMagnitudes(const BigInteger &a, const BigInteger &b, BigInteger &quotient, BigInteger &remainder);
+
+    static const BigInteger &decimalPower(size_t k);
+    static BigInteger reciprocal(const BigInteger &p);
+    static const BigInteger &decimalReciprocal(size_t k);
+    static void divideByDecimalPower(const BigInteger &x, size_t k, BigInteger &quotient, BigInteger &remainder);
+    static BigInteger fromDecimal(const char *digits, size_t length);
+    static char *writeDecimal(const BigInteger &x, char *out, size_t width);
+
+public:
+
+    BigInteger();
+
+    ~BigInteger() = default;
+    BigInteger(const BigInteger &other) = default;
+    BigInteger(BigInteger &&other) = default;
+    explicit BigInteger(const std::string &string);
+
+    BigInteger(long long value);
+    BigInteger &operator=(const BigInteger &other) = default;
+
+    BigInteger &operator=(BigInteger &&other) = default;
+    std::string toString() const;
+    char *toChars(char *first, char *last) const;
+
+    size_t getSize() const;
+
+    unsigned long long getDigit(size_t pos) const;
+    const BigInteger operator-() const;
+
+    BigInteger &operator++();
+
+    BigInteger &operator--();
+    const BigInteger operator++(int);
+
+    const BigInteger operator--(int);
+    BigInteger &operator+=(const BigInteger &a);
+
+    //in-place single-limb versions, without a temporary BigInteger
+    BigInteger &operator+=(long long a);
+    BigInteger &operator-=(long long a);
+    BigInteger &operator*=(long long a);
+    BigInteger &operator/=(long long a);
+
+    BigInteger &naiveMultiply(const BigInteger &other);
+
+    //operand sizes in limbs where operator*= switches from schoolbook to Karatsuba's
+    //and from Karatsuba's to the NTT, tuned by main.cpp --benchmark-thresholds
+    static size_t karatsuba_threshold;
+    static size_t ntt_threshold;
+    //divisor size in limbs from which division is recursive, tuned by --benchmark-division
+    static size_t burnikel_ziegler_threshold;
+    //threads operator*= may use, and the operand size in limbs below which Karatsuba's
+    //products stay on one thread; see --benchmark-threads
+    static size_t multiply_threads;
+    static size_t parallel_threshold;
+    BigInteger &operator-=(const BigInteger &a);
+    BigInteger &operator*=(const BigInteger &a);
+    BigInteger &operator/=(const BigInteger &a);
+    BigInteger &operator%=(const BigInteger &a);
+
+    int compare(const BigInteger &other) const;
+
+    explicit operator bool() const;
+
+    friend std::istream &operator>>(std::istream &is, BigInteger &a);
+
+    class Modulus;
+
+};
+
+// Arithmetic modulo a fixed positive number with the reduction constants computed once:
+// Montgomery's reduction for an odd modulus and Barrett's for an even one. Residues are
+// arrays of exactly as many limbs as the modulus, in Montgomery's form for an odd one.
+class BigInteger::Modulus {
+
+private:
+
+    BigInteger value_;
+    size_t size_;
+    bool montgomery_;
+    Limb inverse_;                      //-value^-1 mod 2^64 for Montgomery's reduction
+    LimbVector r_square_;               //2^(128 size) mod value, to enter Montgomery's form
+    LimbVector reciprocal_;             //floor(2^(128 size) / value) for Barrett's reduction
+    size_t buffer_size_;                //limbs of scratch multiply needs
+
+    void reduce(Limb *product, Limb *result, Limb *scratch) const;
+    void multiply(const Limb *a, const Limb *b, Limb *result, Limb *buffer) const;
+
+public:
+
+    explicit Modulus(const BigInteger &value);
+
+    //base^exponent mod value in [0, value) for exponent >= 0, by sliding windows
+    BigInteger power(const BigInteger &base, const BigInteger &exponent) const;
+
+};
+
+std::ostream &operator<<(std::ostream &os, const BigInteger &a);
+
+const BigInteger operator+(const BigInteger &a, const BigInteger &b);
+const BigInteger operator-(const BigInteger &a, const BigInteger &b);
+const BigInteger operator*(const BigInteger &a, const BigInteger &b);
+const BigInteger operator/(const BigInteger &a, const BigInteger &b);
+const BigInteger operator%(const BigInteger &a, const BigInteger &b);
+
+bool operator>(const BigInteger &a, const BigInteger &b);
+bool operator<(const BigInteger &a, const BigInteger &b);
+bool operator>=(const BigInteger &a, const BigInteger &b);
+bool operator<=(const BigInteger &a, const BigInteger &b);
+bool operator==(const BigInteger &a, const BigInteger &b);
+bool operator!=(const BigInteger &a, const BigInteger &b);
+
+BigInteger powmod(const BigInteger &base, const BigInteger &exponent, const BigInteger &modulus);
+
+//std::vector<BigInteger> moves its elements on reallocation only if this holds, and copies them otherwise
+static_assert(std::is_nothrow_move_constructible<BigInteger>::value, "BigInteger moves must not throw");
+static_assert(std::is_nothrow_move_assignable<BigInteger>::value, "BigInteger moves must not throw");
+
+
+size_t BigInteger::karatsuba_threshold = 32;
+size_t BigInteger::ntt_threshold = 3072;
+size_t BigInteger::burnikel_ziegler_threshold = 64;
+size_t BigInteger::multiply_threads = 1;
+size_t BigInteger::parallel_threshold = 512;
+
+BigInteger::BigInteger() : negative_(0) {}
+
+BigInteger::BigInteger(const long long int value) : negative_(value < 0) {
+    //negating in unsigned arithmetic is fine for LLONG_MIN too
+    Limb magnitude = value < 0 ? 0 - (Limb)value : (Limb)value;
+    if (magnitude) {
+        limbs_.push_back(magnitude);
+    }
+}
+
+BigInteger::BigInteger(const std::string &string) : negative_(0) {
+    bool negative = (string[0] == '-');
+    *this = fromDecimal(string.data() + negative, string.size() - negative);
+    negative_ = negative;
+    normalize();
+}
+
+size_t BigInteger::getSize() const {
+    return limbs_.size();
+}
+
+unsigned long long BigInteger::getDigit(size_t pos) const {
+    return pos < limbs_.size() ? limbs_[pos] : 0;
+}
+
+bool BigInteger::isNegative() const {
+    return negative_;
+}
+
+bool BigInteger::isZero() const {
+    return limbs_.empty();
+}
+
+
+void BigInteger::normalize() {
+    while (!limbs_.empty() && limbs_.back() == 0)
+        limbs_.pop_back();
+    if (limbs_.empty()) {
+        negative_ = 0;
+    }
+}
+
+// |this| + |a|, |this| - |a| or, with invert, |a| - |this|; the difference must not be negative.
+// Magnitudes: this + a, this - a for |this| >= |a| or, inverted, a - this for |a| > |this|.
+void BigInteger::add(const BigInteger &a, const bool substract, const bool invert) {
+    if (getSize() < a.getSize())
+        limbs_.resize(a.getSize(), 0);
+
+    if (!substract) {
+        if (addTo(limbs_.data(), getSize(), a.limbs_.data(), a.getSize()))
+            limbs_.push_back(1);
+    }
+    else if (invert)
+        subtractReversed(limbs_.data(), a.limbs_.data(), getSize());
+    else
+        subtractFrom(limbs_.data(), getSize(), a.limbs_.data(), a.getSize());
+
+    negative_ = negative_ ^ invert;
+
+    normalize();
+}
+
+const BigInteger BigInteger::operator-() const {
+    BigInteger a = *this;
+    a.negative_ = !isZero() && !negative_;
+    return a;
+}
+
+BigInteger &BigInteger::operator++() {
+    *this += 1;
+    return *this;
+}
+
+BigInteger &BigInteger::operator--() {
+    *this -= 1;
+    return *this;
+}
+
+const BigInteger BigInteger::operator++(int) {
+    BigInteger a(*this);
+    *this += 1;
+    return a;
+}
+
+const BigInteger BigInteger::operator--(int) {
+    BigInteger a(*this);
+    *this -= 1;
+    return a;
+}
+
+// this + a with a taken with the given sign, comparing magnitudes in place.
+BigInteger &BigInteger::addSigned(const BigInteger &a, bool negative) {
+    if (negative_ == negative)
+        add(a, 0, 0);
+    else if (compareMagnitudes(limbs_, a.limbs_) >= 0)
+        add(a, 1, 0);
+    else
+        add(a, 1, 1);
+    return *this;
+}
+
+BigInteger &BigInteger::operator+=(const BigInteger &a) {
+    return addSigned(a, a.negative_);
+}
+
+BigInteger &BigInteger::operator-=(const BigInteger &a) {
+    return addSigned(a, !a.negative_);
+}
+
+BigInteger &BigInteger::operator*=(const BigInteger &a) {
+    return multiply(a);
+}
+
+BigInteger &BigInteger::operator/=(const BigInteger &a) {
+    bool negative = negative_ != a.negative_;
+    divide(a);
+    negative_ = !isZero() && negative;
+    return *this;
+}
+
+// this + value with the given sign for a single limb, in place.
+BigInteger &BigInteger::addLimb(Limb value, bool negative) {
+    if (!value)
+        return *this;
+    if (isZero()) {
+        limbs_.push_back(value);
+        negative_ = negative;
+        return *this;
+    }
+
+    if (negative_ == negative) {
+        Limb carry = value;
+        for (size_t i = 0; carry && i < getSize(); ++i) {
+            limbs_[i] += carry;
+            carry = limbs_[i] < carry;
+        }
+        if (carry)
+            limbs_.push_back(carry);
+    }
+    else if (getSize() > 1 || limbs_[0] >= value) {
+        Limb borrow = value;
+        for (size_t i = 0; borrow; ++i) {
+            Limb minuend = limbs_[i];
+            limbs_[i] = minuend - borrow;
+            borrow = minuend < borrow;
+        }
+        normalize();
+    }
+    else {
+        limbs_[0] = value - limbs_[0];
+        negative_ = negative;
+    }
+    return *this;
+}
+
+BigInteger &BigInteger::operator+=(long long a) {
+    return addLimb(a < 0 ? 0 - (Limb)a : (Limb)a, a < 0);
+}
+
+BigInteger &BigInteger::operator-=(long long a) {
+    return addLimb(a < 0 ? 0 - (Limb)a : (Limb)a, a > 0);
+}
+
+BigInteger &BigInteger::operator*=(long long a) {
+    if (!a) {
+        limbs_.clear();
+        negative_ = 0;
+        return *this;
+    }
+    multiplyAddLimb(a < 0 ? 0 - (Limb)a : (Limb)a, 0);
+    negative_ = !isZero() && (negative_ != (a < 0));
+    return *this;
+}
+
+BigInteger &BigInteger::operator/=(long long a) {
+    bool negative = negative_ != (a < 0);
+    divideByLimb(a < 0 ? 0 - (Limb)a : (Limb)a);
+    negative_ = !isZero() && negative;
+    return *this;
+}
+
+BigInteger &BigInteger::operator%=(const BigInteger &a) {
+    divide(a, 1);
+    return *this;
+}
+
+int BigInteger::compareMagnitudes(const LimbVector &a, const LimbVector &b) {
+    if (a.size() != b.size())
+        return a.size() > b.size() ? 1 : -1;
+
+    return compareLimbs(a.data(), b.data(), a.size());
+}
+
+// Compares a[0, n) with b[0, n) from the top. Blocks of four limbs are tested for
+// equality with one branch, which the compiler turns into vector instructions.
+int BigInteger::compareLimbs(const Limb *a, const Limb *b, size_t n) {
+    size_t i = n;
+    for (; i >= 4; i -= 4) {
+        const Limb *x = a + i - 4, *y = b + i - 4;
+        if ((x[0] ^ y[0]) | (x[1] ^ y[1]) | (x[2] ^ y[2]) | (x[3] ^ y[3]))
+            break;
+    }
+    for (; i > 0; --i)
+        if (a[i - 1] != b[i - 1])
+            return a[i - 1] > b[i - 1] ? 1 : -1;
+
+    return 0;
+}
+
+// Divides the magnitude in place, returns the remainder.
+BigInteger::Limb BigInteger::divideByLimb(Limb divisor) {
+    Limb remainder = 0, *limbs = limbs_.data();
+    for (size_t i = getSize() - 1; i < getSize(); --i) {
+        DoubleLimb current = ((DoubleLimb)remainder << 64) | limbs[i];
+        limbs[i] = (Limb)(current / divisor);
+        remainder = (Limb)(current % divisor);
+    }
+    normalize();
+    return remainder;
+}
+
+// |this| = |this| * multiplier + addend
+void BigInteger::multiplyAddLimb(Limb multiplier, Limb addend) {
+    Limb carry = addend, *limbs = limbs_.data();
+    const size_t size = getSize();
+    for (size_t i = 0; i < size; ++i) {
+        DoubleLimb current = (DoubleLimb)limbs[i] * multiplier + carry;
+        limbs[i] = (Limb)current;
+        carry = (Limb)(current >> 64);
+    }
+    if (carry)
+        limbs_.push_back(carry);
+}
+
+// Truncating division, the remainder keeps the sign of the dividend.
+void BigInteger::divide(const BigInteger &divisor, bool modulo) {
+    bool negative = negative_;
+    BigInteger quotient, remainder;
+    divideMagnitudes(*this, divisor, quotient, remainder);
+
+    if (!modulo)
+        limbs_.swap(quotient.limbs_);
+    else
+        limbs_.swap(remainder.limbs_);
+
+    negative_ = negative;
+    normalize();
+}
+
+// Magnitude of limbs [from, to), that is |this| / B^from mod B^(to - from) for B = 2^64.
+BigInteger BigInteger::limbRange(size_t from, size_t to) const {
+    BigInteger result;
+    to = std::min(to, getSize());
+    if (from < to)
+        result.limbs_.assign(limbs_.begin() + from, limbs_.begin() + to);
+    result.normalize();
+    return result;
+}
+
+// high * B^k + low for non-negative high and low < B^k.
+BigInteger BigInteger::concatenate(const BigInteger &high, const BigInteger &low, size_t k) {
+    BigInteger result;
+    if (high.isZero()) {
+        result.limbs_ = low.limbs_;
+        return result;
+    }
+    result.limbs_.reserve(k + high.getSize());
+    result.limbs_.assign(low.limbs_.begin(), low.limbs_.end());
+    result.limbs_.resize(k, 0);
+    result.limbs_.append(high.limbs_.begin(), high.limbs_.end());
+    return result;
+}
+
+void BigInteger::shiftLeft(int bits) {
+    if (!bits || isZero())
+        return;
+    limbs_.push_back(0);
+    for (size_t i = getSize() - 1; i > 0; --i)
+        limbs_[i] = limbs_[i] << bits | limbs_[i - 1] >> (64 - bits);
+    limbs_[0] <<= bits;
+    normalize();
+}
+
+void BigInteger::shiftRight(int bits) {
+    if (!bits || isZero())
+        return;
+    for (size_t i = 0; i + 1 < getSize(); ++i)
+        limbs_[i] = limbs_[i] >> bits | limbs_[i + 1] << (64 - bits);
+    limbs_.back() >>= bits;
+    normalize();
+}
+
+// Knuth's algorithm D: quotient[0, n - m + 1) and remainder[0, m) of u[0, n) / v[0, m)
+// for n >= m >= 2 and v[m - 1] != 0. Both operands are shifted so that the top bit of
+// the divisor is set, then a quotient limb estimated from the top limbs is at most
+// one too large after the correction by the second limb of the divisor.
+void BigInteger::divideKnuth(const Limb *u, size_t n, const Limb *v, size_t m, Limb *quotient, Limb *remainder) {
+    const int shift = __builtin_clzll(v[m - 1]);
+    std::vector<Limb> vn(m), un(n + 1);
+    for (size_t i = m - 1; i > 0; --i)
+        vn[i] = v[i] << shift | (shift ? v[i - 1] >> (64 - shift) : 0);
+    vn[0] = v[0] << shift;
+    un[n] = shift ? u[n - 1] >> (64 - shift) : 0;
+    for (size_t i = n - 1; i > 0; --i)
+        un[i] = u[i] << shift | (shift ? u[i - 1] >> (64 - shift) : 0);
+    un[0] = u[0] << shift;
+
+    for (size_t j = n - m; j <= n - m; --j) {
+        DoubleLimb numerator = (DoubleLimb)un[j + m] << 64 | un[j + m - 1];
+        DoubleLimb estimate = numerator / vn[m - 1], rest = numerator % vn[m - 1];
+        while (estimate >> 64 || estimate * vn[m - 2] > (rest << 64 | un[j + m - 2])) {
+            --estimate;
+            rest += vn[m - 1];
+            if (rest >> 64)
+                break;
+        }
+
+        //un[j, j + m] -= estimate * vn
+        Limb digit = (Limb)estimate, carry = 0, borrow = 0;
+        for (size_t i = 0; i < m; ++i) {
+            DoubleLimb product = (DoubleLimb)digit * vn[i] + carry;
+            carry = (Limb)(product >> 64);
+            //the borrow is the top bit of the 128-bit difference, without branches
+            DoubleLimb difference = (DoubleLimb)un[i + j] - (Limb)product - borrow;
+            un[i + j] = (Limb)difference;
+            borrow = (Limb)(difference >> 64) & 1;
+        }
+        Limb top = un[j + m];
+        un[j + m] = top - carry - borrow;
+        if (top < carry || (top == carry && borrow)) {
+            --digit;
+            un[j + m] += addTo(un.data() + j, m, vn.data(), m);
+        }
+        quotient[j] = digit;
+    }
+
+    for (size_t i = 0; i < m; ++i)
+        remainder[i] = un[i] >> shift | (shift ? un[i + 1] << (64 - shift) : 0);
+}
+
+void BigInteger::divideSchoolbook(const BigInteger &a, const BigInteger &b, BigInteger &quotient, BigInteger &remainder) {
+    quotient.limbs_.clear();
+    remainder.limbs_.clear();
+    quotient.negative_ = remainder.negative_ = 0;
+    if (compareMagnitudes(a.limbs_, b.limbs_) < 0) {
+        remainder.limbs_ = a.limbs_;
+        return;
+    }
+    if (b.getSize() == 1) {
+        quotient.limbs_ = a.limbs_;
+        Limb rest = quotient.divideByLimb(b.limbs_[0]);
+        if (rest)
+            remainder.limbs_.push_back(rest);
+        return;
+    }
+    quotient.limbs_.resize(a.getSize() - b.getSize() + 1);
+    remainder.limbs_.resize(b.getSize());
+    divideKnuth(a.limbs_.data(), a.getSize(), b.limbs_.data(), b.getSize(),
+                quotient.limbs_.data(), remainder.limbs_.data());
+    quotient.normalize();
+    remainder.normalize();
+}
+
+// Burnikel-Ziegler recursive division of a < B^n b by b of exactly n limbs with the
+// top bit set: the quotient has n limbs and is found as two halves, each by a division
+// of 3 half-limb-blocks by 2, which in turn takes one recursive division and one
+// multiplication.
+void BigInteger::divideTwoByOne(const BigInteger &a, const BigInteger &b, size_t n,
+                                BigInteger &quotient, BigInteger &remainder) {
+    //a single limb can't be halved, whatever the threshold says
+    if (n < std::max<size_t>(burnikel_ziegler_threshold, 2)) {
+        divideSchoolbook(a, b, quotient, remainder);
+        return;
+    }
+    if (n % 2) {
+        divideTwoByOne(concatenate(a, BigInteger(), 1), concatenate(b, BigInteger(), 1), n + 1, quotient, remainder);
+        remainder = remainder.limbRange(1, remainder.getSize());
+        return;
+    }
+
+    size_t half = n / 2;
+    BigInteger b1 = b.limbRange(half, n), b2 = b.limbRange(0, half);
+    BigInteger high_quotient, low_quotient, rest;
+    divideThreeByTwo(a.limbRange(n, a.getSize()), a.limbRange(half, n), b, b1, b2, half, high_quotient, rest);
+    divideThreeByTwo(rest, a.limbRange(0, half), b, b1, b2, half, low_quotient, remainder);
+    quotient = concatenate(high_quotient, low_quotient, half);
+}
+
+void BigInteger::divideThreeByTwo(const BigInteger &a12, const BigInteger &a3, const BigInteger &b,
+                                  const BigInteger &b1, const BigInteger &b2, size_t n,
+                                  BigInteger &quotient, BigInteger &remainder) {
+    if (compareMagnitudes(a12.limbRange(n, a12.getSize()).limbs_, b1.limbs_) == 0) {
+        //the quotient estimate a12 / b1 would have n + 1 limbs, B^n - 1 is enough
+        quotient.limbs_.assign(n, ~(Limb)0);
+        quotient.negative_ = 0;
+        remainder = a12 - concatenate(b1, BigInteger(), n) + b1;
+    }
+    else {
+        divideTwoByOne(a12, b1, n, quotient, remainder);
+    }
+    remainder = concatenate(remainder, a3, n) - quotient * b2;
+    while (remainder.isNegative()) {
+        --quotient;
+        remainder += b;
+    }
+}
+
+// Quotient and remainder of |a| / |b|. Long divisors are normalized so that their top
+// bit is set, and the dividend is divided block by block of the divisor's length.
+void BigInteger::divideMagnitudes(const BigInteger &a, const BigInteger &b, BigInteger &quotient, BigInteger &remainder) {
+    if (b.getSize() < burnikel_ziegler_threshold || compareMagnitudes(a.limbs_, b.limbs_) < 0) {
+        divideSchoolbook(a, b, quotient, remainder);
+        return;
+    }
+
+    const int shift = __builtin_clzll(b.limbs_.back());
+    BigInteger dividend = a.limbRange(0, a.getSize()), divisor = b.limbRange(0, b.getSize());
+    dividend.shiftLeft(shift);
+    divisor.shiftLeft(shift);
+    const size_t n = divisor.getSize(), blocks = (dividend.getSize() + n - 1) / n;
+
+    remainder = BigInteger();
+    quotient.limbs_.assign(blocks * n, 0);
+    quotient.negative_ = 0;
+    for (size_t i = blocks - 1; i < blocks; --i) {
+        BigInteger block_quotient;
+        divideTwoByOne(concatenate(remainder, dividend.limbRange(i * n, (i + 1) * n), n), divisor, n,
+                       block_quotient, remainder);
+        std::copy(block_quotient.limbs_.begin(), block_quotient.limbs_.end(), quotient.limbs_.begin() + i * n);
+    }
+    quotient.normalize();
+    remainder.shiftRight(shift);
+}
+
+std::ostream &operator<<(std::ostream &os, const BigInteger &a) {
+    return os << a.toString();
+}
+
+std::istream &operator>>(std::istream &is, BigInteger &a) {
+    std::string input;
+    is >> input;
+    a = BigInteger(input);
+    return is;
+}
+
+const BigInteger operator+(const BigInteger &a, const BigInteger &b) {
+    BigInteger c = a;
+    c += b;
+    return c;
+}
+
+const BigInteger operator-(const BigInteger &a, const BigInteger &b) {
+    BigInteger c = a;
+    c -= b;
+    return c;
+}
+
+const BigInteger operator*(const BigInteger &a, const BigInteger &b) {
+    BigInteger c = a;
+    c *= b;
+    return c;
+}
+
+const BigInteger operator/(const BigInteger &a, const BigInteger &b) {
+    BigInteger c = a;
+    c /= b;
+    return c;
+}
+
+const BigInteger operator%(const BigInteger &a, const BigInteger &b) {
+    BigInteger c = a;
+    c %= b;
+    return c;
+}
+
+int BigInteger::compare(const BigInteger &other) const {
+    if (negative_ != other.negative_)
+        return other.negative_ ? 1 : -1;
+
+    int result = compareMagnitudes(limbs_, other.limbs_);
+    return negative_ ? -result : result;
+}
+
+bool operator>(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) == 1;
+}
+
+bool operator<(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) == -1;
+}
+
+bool operator>=(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) >= 0;
+}
+
+bool operator<=(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) <= 0;
+}
+
+bool operator==(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) == 0;
+}
+
+bool operator!=(const BigInteger &a, const BigInteger &b) {
+    return a.compare(b) != 0;
+}
+
+BigInteger::operator bool() const {
+    return !isZero();
+}
+
+// 10^(decimal_base_len_ 2^k), squared from the previous one on the first request.
+// A deque keeps references to the computed powers valid while new ones are added.
+const BigInteger &BigInteger::decimalPower(size_t k) {
+    static thread_local std::deque<BigInteger> powers;
+    if (powers.empty()) {
+        powers.emplace_back();
+        powers.back().limbs_.push_back(Limb(decimal_base_));
+    }
+    while (powers.size() <= k)
+        powers.push_back(powers.back() * powers.back());
+    return powers[k];
+}
+
+// floor(B^(2 s) / p) for p of s limbs by Newton's iteration. The reciprocal of the top h
+// limbs of p, about half of them, is right to about h limbs; one step r + r (B^(2 s) - p r) / B^(2 s)
+// doubles that, and the last few units are corrected by the remainder. This costs a few
+// multiplications of s by s / 2 limbs instead of a recursive division.
+BigInteger BigInteger::reciprocal(const BigInteger &p) {
+    const size_t size = p.getSize();
+    BigInteger power;
+    power.limbs_.assign(2 * size, 0);
+    power.limbs_.push_back(1);
+
+    BigInteger result, remainder;
+    //for a few limbs the top high limbs are all of p and the recursion would not shrink;
+    //the threshold is clamped so that a huge one doesn't overflow
+    if (size <= std::max<size_t>(2 * std::min<size_t>(burnikel_ziegler_threshold, size), 8)) {
+        divideMagnitudes(power, p, result, remainder);
+        return result;
+    }
+
+    const size_t high = (size + 1) / 2 + 2, shift = size - high;
+    BigInteger top = reciprocal(p.limbRange(shift, size));
+    BigInteger error = power - concatenate(p * top, BigInteger(), shift);
+    //r (B^(2 s) - p r) / B^(2 s) is needed only to a unit, so the low size - 2 limbs of
+    //the error are dropped and the product is half-sized
+    BigInteger correction = top * error.limbRange(size - 2, error.getSize());
+    correction = correction.limbRange(high + 2, correction.getSize());
+    result = concatenate(top, BigInteger(), shift);
+    if (error.isNegative()) {
+        result -= correction;
+        remainder = error + p * correction;
+    }
+    else {
+        result += correction;
+        remainder = error - p * correction;
+    }
+    while (remainder.isNegative()) {
+        --result;
+        remainder += p;
+    }
+    while (compareMagnitudes(remainder.limbs_, p.limbs_) >= 0) {
+        ++result;
+        remainder -= p;
+    }
+    return result;
+}
+
+// floor(B^(2 s) / decimalPower(k)) for the s limbs of the power, for Barrett's reduction.
+const BigInteger &BigInteger::decimalReciprocal(size_t k) {
+    static thread_local std::deque<BigInteger> reciprocals;
+    while (reciprocals.size() <= k)
+        reciprocals.push_back(reciprocal(decimalPower(reciprocals.size())));
+    return reciprocals[k];
+}
+
+// Barrett's division of x >= 0 by decimalPower(k) of s limbs. x goes by blocks of s limbs
+// from the top, so every partial dividend is below B^(2 s), and its quotient estimated
+// from the top limbs and the reciprocal is at most 2 too small.
+void BigInteger::divideByDecimalPower(const BigInteger &x, size_t k, BigInteger &quotient, BigInteger &remainder) {
+    const BigInteger &power = decimalPower(k), &inverse = decimalReciprocal(k);
+    const size_t size = power.getSize(), blocks = (x.getSize() + size - 1) / size;
+
+    remainder = BigInteger();
+    quotient.limbs_.assign(blocks * size, 0);
+    quotient.negative_ = 0;
+    for (size_t i = blocks - 1; i < blocks; --i) {
+        remainder = concatenate(remainder, x.limbRange(i * size, (i + 1) * size), size);
+        if (compareMagnitudes(remainder.limbs_, power.limbs_) < 0)
+            continue;
+
+        BigInteger digit = remainder.limbRange(size - 1, remainder.getSize()) * inverse;
+        digit = digit.limbRange(size + 1, digit.getSize());
+        remainder -= digit * power;
+        while (compareMagnitudes(remainder.limbs_, power.limbs_) >= 0) {
+            remainder -= power;
+            ++digit;
+        }
+        std::copy(digit.limbs_.begin(), digit.limbs_.end(), quotient.limbs_.begin() + i * size);
+    }
+    quotient.normalize();
+}
+
+// Short numbers are read decimal_base_len_ digits at a time, the first chunk takes the
+// remainder. Long ones are split into a high part and a low part of
+// decimal_base_len_ 2^k digits, so the conversion costs O(M(n) log n).
+BigInteger BigInteger::fromDecimal(const char *digits, size_t length) {
+    BigInteger result;
+    if (length <= decimal_base_len_ * decimal_conversion_threshold_) {
+        size_t begin = 0;
+        size_t chunk = length % decimal_base_len_;
+        if (!chunk)
+            chunk = decimal_base_len_;
+        while (begin < length) {
+            Limb value = 0, multiplier = 1;
+            for (size_t i = begin; i < begin + chunk; ++i) {
+                value = value * 10 + (digits[i] - '0');
+                multiplier *= 10;
+            }
+            result.multiplyAddLimb(multiplier, value);
+            begin += chunk;
+            chunk = decimal_base_len_;
+        }
+        result.normalize();
+        return result;
+    }
+
+    size_t k = 0;
+    while ((size_t)decimal_base_len_ << (k + 1) < length)
+        ++k;
+    size_t low_length = (size_t)decimal_base_len_ << k;
+    result = fromDecimal(digits, length - low_length);
+    result *= decimalPower(k);
+    result += fromDecimal(digits + length - low_length, low_length);
+    return result;
+}
+
+// Writes x >= 0 to out, zero-padded to width digits if width isn't 0, and returns the end.
+// Padded widths are always decimal_base_len_ 2^k, so a long number splits into halves
+// by one division by decimalPower(k - 1); an unpadded one splits at the power whose
+// square is about its size.
+char *BigInteger::writeDecimal(const BigInteger &x, char *out, size_t width) {
+    if (x.getSize() <= decimal_conversion_threshold_) {
+        BigInteger rest = x.limbRange(0, x.getSize());
+        Limb chunks[decimal_conversion_threshold_ * 20 / decimal_base_len_ + 1];
+        size_t count = 0;
+        while (!rest.isZero())
+            chunks[count++] = rest.divideByLimb(decimal_base_);
+
+        char top[decimal_base_len_];
+        size_t top_length = 0;
+        for (Limb chunk = count ? chunks[count - 1] : 0; chunk; chunk /= 10)
+            top[decimal_base_len_ - ++top_length] = '0' + chunk % 10;
+        size_t length = count ? (count - 1) * decimal_base_len_ + top_length : 0;
+        if (width > length)
+            out = std::fill_n(out, width - length, '0');
+        out = std::copy(top + decimal_base_len_ - top_length, top + decimal_base_len_, out);
+        for (size_t i = count; i > 1; --i) {
+            Limb chunk = chunks[i - 2];
+            for (int j = decimal_base_len_ - 1; j >= 0; --j, chunk /= 10)
+                out[j] = '0' + chunk % 10;
+            out += decimal_base_len_;
+        }
+        return out;
+    }
+
+    size_t k = 0;
+    if (width) {
+        while ((size_t)decimal_base_len_ << (k + 2) <= width)
+            ++k;
+    }
+    else {
+        while (2 * decimalPower(k + 1).getSize() <= x.getSize() + 1)
+            ++k;
+    }
+    BigInteger quotient, remainder;
+    divideByDecimalPower(x, k, quotient, remainder);
+    size_t low_width = (size_t)decimal_base_len_ << k;
+    out = writeDecimal(quotient, out, width ? width - low_width : 0);
+    return writeDecimal(remainder, out, low_width);
+}
+
+// Like std::to_chars: writes the decimal representation to [first, last) and returns
+// the end of it, or nullptr if 20 getSize() + 2 characters don't fit.
+char *BigInteger::toChars(char *first, char *last) const {
+    if ((size_t)(last - first) < 20 * getSize() + 2)
+        return nullptr;
+    if (isZero()) {
+        *first = '0';
+        return first + 1;
+    }
+    if (negative_)
+        *first++ = '-';
+    return writeDecimal(negative_ ? -*this : *this, first, 0);
+}
+
+std::string BigInteger::toString() const {
+    std::string result(20 * getSize() + 2, '0');
+    result.resize(toChars(&result[0], &result[0] + result.size()) - &result[0]);
+    return result;
+}
+
+// One step of a carry chain, sum = a + b + carry, returning the carry out; on x86-64 this
+// is a single adc, so a chain of them runs without branches or flag round trips.
+inline unsigned char BigInteger::addWithCarry(unsigned char carry, Limb a, Limb b, Limb &sum) {
+#if defined(__x86_64__)
+    unsigned long long result;
+    carry = _addcarry_u64(carry, a, b, &result);
+    sum = result;
+    return carry;
+#else
+    DoubleLimb temp = (DoubleLimb)a + b + carry;
+    sum = (Limb)temp;
+    return (unsigned char)(temp >> 64);
+#endif
+}
+
+// difference = a - b - borrow, returning the borrow out; a single sbb on x86-64.
+inline unsigned char BigInteger::subtractWithBorrow(unsigned char borrow, Limb a, Limb b, Limb &difference) {
+#if defined(__x86_64__)
+    unsigned long long result;
+    borrow = _subborrow_u64(borrow, a, b, &result);
+    difference = result;
+    return borrow;
+#else
+    DoubleLimb temp = (DoubleLimb)a - b - borrow;
+    difference = (Limb)temp;
+    return (unsigned char)(temp >> 127);
+#endif
+}
+
+// a[0, n) += b[0, m) for m <= n, returns the carry out of a[n - 1].
+BigInteger::Limb BigInteger::addTo(Limb *a, size_t n, const Limb *b, size_t m) {
+    unsigned char carry = 0;
+    size_t i = 0;
+    for (; i < m; ++i)
+        carry = addWithCarry(carry, a[i], b[i], a[i]);
+    for (; carry && i < n; ++i) {
+        carry = ++a[i] == 0;
+    }
+    return carry;
+}
+
+// a[0, n) -= b[0, m) for m <= n, returns the borrow out of a[n - 1].
+BigInteger::Limb BigInteger::subtractFrom(Limb *a, size_t n, const Limb *b, size_t m) {
+    unsigned char borrow = 0;
+    size_t i = 0;
+    for (; i < m; ++i)
+        borrow = subtractWithBorrow(borrow, a[i], b[i], a[i]);
+    for (; borrow && i < n; ++i) {
+        borrow = a[i]-- == 0;
+    }
+    return borrow;
+}
+
+// a[0, n) = b[0, n) - a[0, n) for b >= a.
+void BigInteger::subtractReversed(Limb *a, const Limb *b, size_t n) {
+    unsigned char borrow = 0;
+    for (size_t i = 0; i < n; ++i)
+        borrow = subtractWithBorrow(borrow, b[i], a[i], a[i]);
+}
+
+// result[0, max(n, m)) = |a - b|, returns whether a < b.
+bool BigInteger::absoluteDifference(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result) {
+    size_t size = std::max(n, m);
+    bool less = false;
+    for (size_t i = size - 1; i < size; --i) {
+        Limb a_i = i < n ? a[i] : 0, b_i = i < m ? b[i] : 0;
+        if (a_i != b_i) {
+            less = a_i < b_i;
+            break;
+        }
+    }
+    if (less) {
+        std::swap(a, b);
+        std::swap(n, m);
+    }
+    std::copy(a, a + n, result);
+    std::fill(result + n, result + size, 0);
+    subtractFrom(result, size, b, m);
+    return less;
+}
+
+// result[0, n + m) = a[0, n) * b[0, m); result must not overlap the operands.
+void BigInteger::multiplyNaive(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result) {
+    std::fill(result, result + n + m, 0);
+    for (size_t i = 0; i < n; ++i) {
+        Limb carry = 0;
+        for (size_t j = 0; j < m; ++j) {
+            DoubleLimb temp = (DoubleLimb)a[i] * b[j] + result[i + j] + carry;
+
+            result[i + j] = (Limb)temp;
+            carry = (Limb)(temp >> 64);
+        }
+        result[i + m] = carry;
+    }
+}
+
+size_t BigInteger::karatsubaScratchSize(size_t n) {
+    if (n <= karatsuba_threshold || n < 4 || (n >= ntt_threshold && nttFits(n, n))) {
+        return 0;
+    }
+    size_t high = n - n / 2;
+    return 4 * high + 1 + karatsubaScratchSize(high);
+}
+
+// result[0, 2 n) = a[0, n) * b[0, n) by the subtractive Karatsuba's scheme:
+// a_low b_high + a_high b_low = z0 + z2 + (a_low - a_high)(b_high - b_low), where
+// z0 = a_low b_low and z2 = a_high b_high are computed right in their places in the result.
+// Needs karatsubaScratchSize(n) limbs of scratch: the differences of the halves and their
+// product, then the middle coefficient over the differences, then the scratch of the recursion.
+// Given threads and at least parallel_threshold limbs, the three products run at once.
+void BigInteger::multiplyKaratsuba(const Limb *a, const Limb *b, size_t n, Limb *result, Limb *scratch,
+                                   size_t threads) {
+    if (n <= karatsuba_threshold || n < 4) {
+        multiplyNaive(a, n, b, n, result);
+        return;
+    }
+    if (n >= ntt_threshold && nttFits(n, n)) {
+        nttMultiply(a, n, b, n, result, threads);
+        return;
+    }
+
+    size_t low = n / 2, high = n - low;
+    Limb *product = scratch, *a_difference = scratch + 2 * high, *b_difference = scratch + 3 * high;
+    bool negative;
+    if (threads > 1 && n >= parallel_threshold) {
+        negative = absoluteDifference(a, low, a + low, high, a_difference)
+                   != absoluteDifference(b + low, high, b, low, b_difference);
+        //the halves get scratch of their own so that the three products can run at once
+        std::vector<Limb> low_scratch(karatsubaScratchSize(low)), high_scratch(karatsubaScratchSize(high));
+        runInParallel(threads, [&](size_t share) {
+            multiplyKaratsuba(a, b, low, result, low_scratch.data(), share);
+        }, [&](size_t share) {
+            multiplyKaratsuba(a + low, b + low, high, result + 2 * low, high_scratch.data(), share);
+        }, [&](size_t share) {
+            multiplyKaratsuba(a_difference, b_difference, high, product, scratch + 4 * high + 1, share);
+        });
+    }
+    else {
+        multiplyKaratsuba(a, b, low, result, scratch);
+        multiplyKaratsuba(a + low, b + low, high, result + 2 * low, scratch);
+        negative = absoluteDifference(a, low, a + low, high, a_difference)
+                   != absoluteDifference(b + low, high, b, low, b_difference);
+        multiplyKaratsuba(a_difference, b_difference, high, product, scratch + 4 * high + 1);
+    }
+
+    Limb *middle = scratch + 2 * high;
+    std::copy(result + 2 * low, result + 2 * n, middle);
+    middle[2 * high] = 0;
+    addTo(middle, 2 * high + 1, result, 2 * low);
+    if (negative)
+        subtractFrom(middle, 2 * high + 1, product, 2 * high);
+    else
+        addTo(middle, 2 * high + 1, product, 2 * high);
+    addTo(result + low, 2 * n - low, middle, std::min(2 * high + 1, 2 * n - low));
+}
+
+// result[0, 2 n) = a[0, n)^2: every product a_i a_j for i < j is computed once and doubled
+// by a shift, then the squares a_i^2 are added on the diagonal.
+void BigInteger::squareNaive(const Limb *a, size_t n, Limb *result) {
+    std::fill(result, result + 2 * n, 0);
+    for (size_t i = 0; i < n; ++i) {
+        Limb carry = 0;
+        for (size_t j = i + 1; j < n; ++j) {
+            DoubleLimb temp = (DoubleLimb)a[i] * a[j] + result[i + j] + carry;
+
+            result[i + j] = (Limb)temp;
+            carry = (Limb)(temp >> 64);
+        }
+        result[i + n] = carry;
+    }
+
+    for (size_t i = 2 * n - 1; i > 0; --i)
+        result[i] = result[i] << 1 | result[i - 1] >> 63;
+    result[0] <<= 1;
+
+    Limb carry = 0;
+    for (size_t i = 0; i < n; ++i) {
+        DoubleLimb square = (DoubleLimb)a[i] * a[i];
+        DoubleLimb low = (DoubleLimb)result[2 * i] + (Limb)square + carry;
+        result[2 * i] = (Limb)low;
+        DoubleLimb high = (DoubleLimb)result[2 * i + 1] + (Limb)(square >> 64) + (Limb)(low >> 64);
+        result[2 * i + 1] = (Limb)high;
+        carry = (Limb)(high >> 64);
+    }
+}
+
+// result[0, 2 n) = a[0, n)^2 by Karatsuba's scheme with 2 a_low a_high = z0 + z2 - (a_low - a_high)^2,
+// so the middle product is a square too. Uses the scratch layout of multiplyKaratsuba.
+void BigInteger::squareKaratsuba(const Limb *a, size_t n, Limb *result, Limb *scratch, size_t threads) {
+    if (n <= karatsuba_threshold || n < 4) {
+        squareNaive(a, n, result);
+        return;
+    }
+    if (n >= ntt_threshold && nttFits(n, n)) {
+        nttMultiply(a, n, a, n, result, threads);
+        return;
+    }
+
+    size_t low = n / 2, high = n - low;
+    Limb *square = scratch, *difference = scratch + 2 * high;
+    if (threads > 1 && n >= parallel_threshold) {
+        absoluteDifference(a, low, a + low, high, difference);
+        std::vector<Limb> low_scratch(karatsubaScratchSize(low)), high_scratch(karatsubaScratchSize(high));
+        runInParallel(threads, [&](size_t share) {
+            squareKaratsuba(a, low, result, low_scratch.data(), share);
+        }, [&](size_t share) {
+            squareKaratsuba(a + low, high, result + 2 * low, high_scratch.data(), share);
+        }, [&](size_t share) {
+            squareKaratsuba(difference, high, square, scratch + 4 * high + 1, share);
+        });
+    }
+    else {
+        squareKaratsuba(a, low, result, scratch);
+        squareKaratsuba(a + low, high, result + 2 * low, scratch);
+        absoluteDifference(a, low, a + low, high, difference);
+        squareKaratsuba(difference, high, square, scratch + 4 * high + 1);
+    }
+
+    Limb *middle = scratch + 2 * high;
+    std::copy(result + 2 * low, result + 2 * n, middle);
+    middle[2 * high] = 0;
+    addTo(middle, 2 * high + 1, result, 2 * low);
+    subtractFrom(middle, 2 * high + 1, square, 2 * high);
+    addTo(result + low, 2 * n - low, middle, std::min(2 * high + 1, 2 * n - low));
+}
+
+// Runs the three tasks at once, each called with its share of the threads; with two
+// threads the first and the third run one after another on the calling one.
+template<typename First, typename Second, typename Third>
+void BigInteger::runInParallel(size_t threads, First first, Second second, Third third) {
+    size_t second_threads = std::max<size_t>(threads / 3, 1), third_threads = threads / 3;
+    size_t first_threads = threads - second_threads - third_threads;
+
+    std::thread second_worker(second, second_threads);
+    std::thread third_worker;
+    if (third_threads)
+        third_worker = std::thread(third, third_threads);
+    first(first_threads);
+    if (!third_threads)
+        third(first_threads);
+    second_worker.join();
+    if (third_worker.joinable())
+        third_worker.join();
+}
+
+size_t BigInteger::multiplyScratchSize(size_t n, size_t m) {
+    if (m <= karatsuba_threshold || (m >= ntt_threshold && nttFits(n, m)) || n == m) {
+        return n == m ? karatsubaScratchSize(n) : 0;
+    }
+    size_t rest = n % m ? multiplyScratchSize(m, n % m) : 0;
+    return 2 * m + std::max(karatsubaScratchSize(m), rest);
+}
+
+// result[0, n + m) = a[0, n) * b[0, m) for n >= m > 0, with multiplyScratchSize(n, m) limbs
+// of scratch. Unbalanced operands are multiplied by m-limb blocks of the longer one.
+void BigInteger::multiplyLimbs(const Limb *a, size_t n, const Limb *b, size_t m, Limb *result, Limb *scratch,
+                               size_t threads) {
+    if (m <= karatsuba_threshold) {
+        multiplyNaive(a, n, b, m, result);
+        return;
+    }
+    if (m >= ntt_threshold && nttFits(n, m)) {
+        nttMultiply(a, n, b, m, result, threads);
+        return;
+    }
+    if (n == m) {
+        multiplyKaratsuba(a, b, n, result, scratch, threads);
+        return;
+    }
+
+    Limb *block = scratch;
+    std::fill(result, result + n + m, 0);
+    for (size_t offset = 0; offset < n; offset += m) {
+        size_t size = std::min(m, n - offset);
+        if (size == m)
+            multiplyKaratsuba(a + offset, b, m, block, scratch + 2 * m, threads);
+        else
+            multiplyLimbs(b, m, a + offset, size, block, scratch + 2 * m, threads);
+        addTo(result + offset, n + m - offset, block, m + size);
+    }
+}
+
+BigInteger &BigInteger::multiply(const BigInteger &other) {
+    if (isZero() || other.isZero()) {
+        limbs_.clear();
+        negative_ = 0;
+        return *this;
+    }
+
+    if (getSize() == other.getSize() && (this == &other || limbs_ == other.limbs_)) {
+        LimbVector square(2 * getSize());
+        std::vector<Limb> scratch(karatsubaScratchSize(getSize()));
+        squareKaratsuba(limbs_.data(), getSize(), square.data(), scratch.data(), multiply_threads);
+
+        limbs_.swap(square);
+        negative_ = negative_ != other.negative_;
+        normalize();
+        return *this;
+    }
+
+    const LimbVector &longer = getSize() >= other.getSize() ? limbs_ : other.limbs_;
+    const LimbVector &shorter = getSize() >= other.getSize() ? other.limbs_ : limbs_;
+    LimbVector product(getSize() + other.getSize());
+    std::vector<Limb> scratch(multiplyScratchSize(longer.size(), shorter.size()));
+    multiplyLimbs(longer.data(), longer.size(), shorter.data(), shorter.size(), product.data(), scratch.data(),
+                  multiply_threads);
+
+    limbs_.swap(product);
+    negative_ = negative_ != other.negative_;
+    normalize();
+
+    return *this;
+}
+
+BigInteger &BigInteger::naiveMultiply(const BigInteger &other) {
+    LimbVector product(getSize() + other.getSize());
+    multiplyNaive(limbs_.data(), getSize(), other.limbs_.data(), other.getSize(), product.data());
+
+    limbs_.swap(product);
+    negative_ = negative_ != other.negative_;
+    normalize();
+
+    return *this;
+}
+
+BigInteger::Modulus::Modulus(const BigInteger &value)
+        : value_(value), size_(value.getSize()), montgomery_(value.getDigit(0) & 1), inverse_(0) {
+    const size_t n = size_;
+    BigInteger power;
+    power.limbs_.assign(2 * n, 0);
+    power.limbs_.push_back(1);
+
+    size_t scratch_size = std::max(karatsubaScratchSize(n), multiplyScratchSize(n, n));
+    if (montgomery_) {
+        //Newton's iteration doubles the correct low bits, and m^-1 = m mod 8 for odd m
+        Limb inverse = value.limbs_[0];
+        for (int i = 0; i < 5; ++i)
+            inverse *= 2 - value.limbs_[0] * inverse;
+        inverse_ = 0 - inverse;
+
+        power %= value;
+        r_square_ = power.limbs_;
+        r_square_.resize(n, 0);
+    }
+    else {
+        reciprocal_ = reciprocal(value).limbs_;
+        const size_t r = reciprocal_.size();
+        scratch_size = std::max(scratch_size, 2 * (r + n) + 1 + std::max(
+                multiplyScratchSize(std::max(r, n + 1), std::min(r, n + 1)), multiplyScratchSize(r, n)));
+    }
+    buffer_size_ = 2 * n + 1 + scratch_size;
+}
+
+// result[0, n) = product[0, 2 n) reduced, where product < value^2 for Barrett's reduction
+// and < value 2^(64 n) for Montgomery's, which also divides by 2^(64 n). The product is
+// destroyed.
+void BigInteger::Modulus::reduce(Limb *product, Limb *result, Limb *scratch) const {
+    const size_t n = size_;
+    const Limb *m = value_.limbs_.data();
+    auto less_than_modulus = [n, m](const Limb *x, Limb top) {
+        return !top && compareLimbs(x, m, n) < 0;
+    };
+
+    if (montgomery_) {
+        //adding u m with u = -product / m mod 2^64 clears the lowest limb; the carry out of
+        //limb i + n goes to limb i + n + 1 on the next step
+        Limb top = 0;
+        for (size_t i = 0; i < n; ++i) {
+            Limb u = product[i] * inverse_, carry = 0;
+            for (size_t j = 0; j < n; ++j) {
+                DoubleLimb temp = (DoubleLimb)u * m[j] + product[i + j] + carry;
+                product[i + j] = (Limb)temp;
+                carry = (Limb)(temp >> 64);
+            }
+            DoubleLimb temp = (DoubleLimb)product[i + n] + carry + top;
+            product[i + n] = (Limb)temp;
+            top = (Limb)(temp >> 64);
+        }
+
+        if (!less_than_modulus(product + n, top))
+            subtractFrom(product + n, n, m, n);
+        std::copy(product + n, product + 2 * n, result);
+        return;
+    }
+
+    //Barrett: the quotient estimated from the top n + 1 limbs is at most 2 too small, so
+    //the remainder fits in n + 1 limbs and only those are computed
+    const size_t r = reciprocal_.size();
+    Limb *estimate = scratch, *back = estimate + r + n + 1, *rest = back + r + n;
+    if (r >= n + 1)
+        multiplyLimbs(reciprocal_.data(), r, product + n - 1, n + 1, estimate, rest);
+    else
+        multiplyLimbs(product + n - 1, n + 1, reciprocal_.data(), r, estimate, rest);
+    multiplyLimbs(estimate + n + 1, r, m, n, back, rest);
+    subtractFrom(product, n + 1, back, n + 1);
+
+    while (!less_than_modulus(product, product[n]))
+        subtractFrom(product, n + 1, m, n);
+    std::copy(product, product + n, result);
+}
+
+// result = a b in the residue form, squaring when a == b. result may alias a or b.
+void BigInteger::Modulus::multiply(const Limb *a, const Limb *b, Limb *result, Limb *buffer) const {
+    const size_t n = size_;
+    Limb *product = buffer, *scratch = buffer + 2 * n + 1;
+    if (a == b)
+        squareKaratsuba(a, n, product, scratch);
+    else
+        multiplyLimbs(a, n, b, n, product, scratch);
+    product[2 * n] = 0;
+    reduce(product, result, scratch);
+}
+
+// Sliding windows: the exponent is cut into runs of zeros and windows of at most w bits
+// that start and end with a one, so only the odd powers of the base below 2^w are needed.
+BigInteger BigInteger::Modulus::power(const BigInteger &base, const BigInteger &exponent) const {
+    const size_t n = size_;
+    if (exponent.isZero())
+        return n == 1 && value_.limbs_[0] == 1 ? BigInteger() : BigInteger(1);
+
+    BigInteger reduced = base % value_;
+    if (reduced.isNegative())
+        reduced += value_;
+    reduced.limbs_.resize(n, 0);
+
+    std::vector<Limb> buffer(buffer_size_);
+    const size_t bits = 64 * exponent.getSize() - __builtin_clzll(exponent.limbs_.back());
+    const size_t window = 1 + (bits > 7) + (bits > 23) + (bits > 79) + (bits > 239) + (bits > 671);
+
+    //table[i] = base^(2 i + 1)
+    std::vector<Limb> table(n << (window - 1));
+    if (montgomery_)
+        multiply(reduced.limbs_.data(), r_square_.data(), table.data(), buffer.data());
+    else
+        std::copy(reduced.limbs_.begin(), reduced.limbs_.end(), table.begin());
+    if (window > 1) {
+        std::vector<Limb> square(n);
+        multiply(table.data(), table.data(), square.data(), buffer.data());
+        for (size_t i = 1; i < ((size_t)1 << (window - 1)); ++i)
+            multiply(table.data() + (i - 1) * n, square.data(), table.data() + i * n, buffer.data());
+    }
+
+    auto bit = [&exponent](size_t i) {
+        return exponent.limbs_[i / 64] >> (i % 64) & 1;
+    };
+    LimbVector result(n);
+    bool started = false;
+    for (size_t i = bits; i > 0;) {
+        if (!bit(i - 1)) {
+            multiply(result.data(), result.data(), result.data(), buffer.data());
+            --i;
+            continue;
+        }
+
+        size_t low = i > window ? i - window : 0;
+        while (!bit(low))
+            ++low;
+        size_t value = 0;
+        for (size_t j = i; j > low; --j)
+            value = value << 1 | bit(j - 1);
+        const Limb *power = table.data() + (value >> 1) * n;
+
+        if (!started) {
+            std::copy(power, power + n, result.begin());
+            started = true;
+        }
+        else {
+            for (size_t j = low; j < i; ++j)
+                multiply(result.data(), result.data(), result.data(), buffer.data());
+            multiply(result.data(), power, result.data(), buffer.data());
+        }
+        i = low;
+    }
+
+    if (montgomery_) {
+        std::fill(buffer.begin(), buffer.begin() + 2 * n + 1, 0);
+        std::copy(result.begin(), result.end(), buffer.begin());
+        reduce(buffer.data(), result.data(), buffer.data() + 2 * n + 1);
+    }
+    BigInteger answer;
+    answer.limbs_.swap(result);
+    answer.normalize();
+    return answer;
+}
+
+BigInteger powmod(const BigInteger &base, const BigInteger &exponent, const BigInteger &modulus) {
+    return BigInteger::Modulus(modulus).power(base, exponent);
+}
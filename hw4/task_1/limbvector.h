@@ -0,0 +1,252 @@
+#pragma once
+
+#include <cstdint>
+#include <cstddef>
+#include <cstring>
+#include <algorithm>
+
+// The part of std::vector<uint64_t> BigInteger needs, with up to two limbs stored in the
+// object itself: small numbers and the temporaries of arithmetic on them never touch the
+// heap. A longer array spills to a heap buffer, which a move hands over without copying.
+// The inline limbs share their place with the capacity of the heap buffer, and the data
+// pointer tells which of the two is there, so access needs no branch. The object takes
+// four words, one more than a std::vector. Moves never allocate and never throw.
+
+class LimbVector {
+
+private:
+
+    static constexpr size_t inline_capacity_ = 2;
+
+    uint64_t *data_;                    //inline_ or a heap buffer
+    size_t size_;
+    union {
+        uint64_t inline_[inline_capacity_];
+        size_t capacity_;               //of the heap buffer, always above inline_capacity_
+    };
+
+    bool isInline() const;
+    size_t capacity() const;
+    void reallocate(size_t capacity);
+    void grow(size_t size);
+    void release() noexcept;
+    void take(LimbVector &other) noexcept;
+
+public:
+
+    LimbVector();
+    explicit LimbVector(size_t size, uint64_t value = 0);
+    LimbVector(const LimbVector &other);
+    LimbVector(LimbVector &&other) noexcept;
+    ~LimbVector();
+
+    LimbVector &operator=(const LimbVector &other);
+    LimbVector &operator=(LimbVector &&other) noexcept;
+
+    size_t size() const;
+    bool empty() const;
+    uint64_t *data();
+    const uint64_t *data() const;
+    uint64_t *begin();
+    const uint64_t *begin() const;
+    uint64_t *end();
+    const uint64_t *end() const;
+    uint64_t &operator[](size_t pos);
+    const uint64_t &operator[](size_t pos) const;
+    uint64_t &back();
+    const uint64_t &back() const;
+
+    void reserve(size_t capacity);
+    void resize(size_t size, uint64_t value = 0);
+    void assign(size_t size, uint64_t value);
+    void assign(const uint64_t *first, const uint64_t *last);
+    void append(const uint64_t *first, const uint64_t *last);
+    void push_back(uint64_t value);
+    void pop_back();
+    void clear();
+    void swap(LimbVector &other) noexcept;
+
+};
+
+bool operator==(const LimbVector &a, const LimbVector &b);
+
+
+inline LimbVector::LimbVector() : data_(inline_), size_(0) {}
+
+inline LimbVector::LimbVector(size_t size, uint64_t value) : LimbVector() {
+    assign(size, value);
+}
+
+inline LimbVector::LimbVector(const LimbVector &other) : LimbVector() {
+    assign(other.begin(), other.end());
+}
+
+inline LimbVector::LimbVector(LimbVector &&other) noexcept : LimbVector() {
+    take(other);
+}
+
+inline LimbVector::~LimbVector() {
+    release();
+}
+
+inline LimbVector &LimbVector::operator=(const LimbVector &other) {
+    if (this != &other)
+        assign(other.begin(), other.end());
+    return *this;
+}
+
+inline LimbVector &LimbVector::operator=(LimbVector &&other) noexcept {
+    if (this != &other) {
+        release();
+        take(other);
+    }
+    return *this;
+}
+
+inline bool LimbVector::isInline() const {
+    return data_ == inline_;
+}
+
+inline size_t LimbVector::capacity() const {
+    if (isInline()) {
+        return inline_capacity_;
+    }
+    return capacity_;
+}
+
+// Moves the limbs to a heap buffer of the given capacity, which is above the inline one.
+inline void LimbVector::reallocate(size_t capacity) {
+    uint64_t *buffer = new uint64_t[capacity];
+    std::copy(data_, data_ + size_, buffer);
+    release();
+    data_ = buffer;
+    capacity_ = capacity;
+}
+
+// Makes room for size limbs, at least doubling the capacity as std::vector does.
+inline void LimbVector::grow(size_t size) {
+    if (size > capacity())
+        reallocate(std::max(size, 2 * capacity()));
+}
+
+// Frees the heap buffer and points back at the inline limbs; the size is up to the caller.
+inline void LimbVector::release() noexcept {
+    if (!isInline())
+        delete[] data_;
+    data_ = inline_;
+}
+
+// Moves the limbs of other into this inline and empty vector, leaving other so.
+inline void LimbVector::take(LimbVector &other) noexcept {
+    size_ = other.size_;
+    if (other.isInline()) {
+        std::copy(other.inline_, other.inline_ + size_, inline_);
+    }
+    else {
+        data_ = other.data_;
+        capacity_ = other.capacity_;
+        other.data_ = other.inline_;
+    }
+    other.size_ = 0;
+}
+
+inline size_t LimbVector::size() const {
+    return size_;
+}
+
+inline bool LimbVector::empty() const {
+    return !size_;
+}
+
+inline uint64_t *LimbVector::data() {
+    return data_;
+}
+
+inline const uint64_t *LimbVector::data() const {
+    return data_;
+}
+
+inline uint64_t *LimbVector::begin() {
+    return data();
+}
+
+inline const uint64_t *LimbVector::begin() const {
+    return data();
+}
+
+inline uint64_t *LimbVector::end() {
+    return data_ + size_;
+}
+
+inline const uint64_t *LimbVector::end() const {
+    return data_ + size_;
+}
+
+inline uint64_t &LimbVector::operator[](size_t pos) {
+    return data_[pos];
+}
+
+inline const uint64_t &LimbVector::operator[](size_t pos) const {
+    return data_[pos];
+}
+
+inline uint64_t &LimbVector::back() {
+    return data_[size_ - 1];
+}
+
+inline const uint64_t &LimbVector::back() const {
+    return data_[size_ - 1];
+}
+
+inline void LimbVector::reserve(size_t capacity) {
+    if (capacity > this->capacity())
+        reallocate(capacity);
+}
+
+inline void LimbVector::resize(size_t size, uint64_t value) {
+    grow(size);
+    if (size > size_)
+        std::fill(data_ + size_, data_ + size, value);
+    size_ = size;
+}
+
+inline void LimbVector::assign(size_t size, uint64_t value) {
+    size_ = 0;
+    resize(size, value);
+}
+
+// [first, last) must not point into this vector.
+inline void LimbVector::assign(const uint64_t *first, const uint64_t *last) {
+    size_ = 0;
+    append(first, last);
+}
+
+inline void LimbVector::append(const uint64_t *first, const uint64_t *last) {
+    size_t count = last - first;
+    grow(size_ + count);
+    std::copy(first, last, data_ + size_);
+    size_ += count;
+}
+
+inline void LimbVector::push_back(uint64_t value) {
+    grow(size_ + 1);
+    data_[size_++] = value;
+}
+
+inline void LimbVector::pop_back() {
+    --size_;
+}
+
+inline void LimbVector::clear() {
+    size_ = 0;
+}
+
+inline void LimbVector::swap(LimbVector &other) noexcept {
+    LimbVector temp(std::move(other));
+    other = std::move(*this);
+    *this = std::move(temp);
+}
+
+inline bool operator==(const LimbVector &a, const LimbVector &b) {
+    return a.size() == b.size() && std::equal(a.begin(), a.end(), b.begin());
+}
@@ -1,56 +1,411 @@
-#include <iostream>
-#include <iomanip>
-#include <sstream>
-#include <random>
-#include <chrono>
-#include "biginteger.h"
-
-using namespace std;
-
-int main() {
-    const size_t tries = 13;
-    const size_t size = 10000;
-
-    mt19937_64 rd(chrono::system_clock::now().time_since_epoch().count());
-    uniform_int_distribution<char> ds_digit('0', '9');
-
-    long long karatsuba_time = 0, naive_time = 0;
-
-    for (int i = 0; i < tries; ++i) {
-        string iss_str;
-        auto delimiter = size / 2;
-        for (size_t j = 0; j < size; ++j) {
-            if (j == delimiter) {
-                iss_str.push_back(' ');
-            }
-            if ((j == delimiter || j == 0) && rd() % 2) {
-                iss_str.push_back('-');
-            }
-            iss_str.push_back(ds_digit(rd));
-        }
-        istringstream iss(iss_str);
-        BigInteger a, b, c, d;
-        iss >> a >> b;
-        c = a;
-        d = b;
-
-        auto time_start = chrono::steady_clock::now();
-        a *= b;
-        auto time_end = chrono::steady_clock::now();
-
-        karatsuba_time += (time_end - time_start).count();
-
-        time_start = chrono::steady_clock::now();
-        a.naiveMultiply(b);
-        time_end = chrono::steady_clock::now();
-
-        naive_time += (time_end - time_start).count();
-    }
-    cout << setw(14) << left << "Time"        << setw(14) << "Overall"      << "Average"              << '\n';
-    cout << setw(14) << left << "Karatsuba's" << setw(14) << karatsuba_time << karatsuba_time / tries << '\n';
-    cout << setw(14) << left << "Naive"       << setw(14) << naive_time     << naive_time / tries     << '\n';
-    cout << '\n';
-    cout << "Karatsuba's " << (double)naive_time / karatsuba_time << " times faster." << '\n';
-
-    return 0;
-}
+#include <iostream>
+#include <iomanip>
+#include <sstream>
+#include <random>
+#include <chrono>
+#include <limits>
+#include <thread>
+#include "biginteger.h"
+
+using namespace std;
+
+BigInteger randomBigInteger(size_t limbs, mt19937_64 &rd) {
+    uniform_int_distribution<int> ds_digit(0, 9);
+    string digits(limbs * 64 * 0.30103, '0');
+    for (auto &digit : digits) {
+        digit += ds_digit(rd);
+    }
+    return BigInteger(digits);
+}
+
+// Average time of a * b, repeated until at least 20 ms have passed.
+long long measureMultiply(const BigInteger &a, const BigInteger &b) {
+    long long elapsed = 0, count = 0;
+    while (elapsed < 20000000) {
+        BigInteger c = a;
+        auto time_start = chrono::steady_clock::now();
+        c *= b;
+        auto time_end = chrono::steady_clock::now();
+        elapsed += (time_end - time_start).count();
+        ++count;
+    }
+    return elapsed / count;
+}
+
+// Times every multiplication tier on operands of equal size to find the crossovers,
+// and squaring with the default thresholds.
+void benchmarkThresholds() {
+    mt19937_64 rd(0);
+    const size_t default_karatsuba = BigInteger::karatsuba_threshold, default_ntt = BigInteger::ntt_threshold;
+    const size_t never = numeric_limits<size_t>::max();
+
+    cout << setw(14) << left << "Limbs" << setw(14) << "Naive, us" << setw(14) << "Karatsuba, us" << setw(14) << "NTT, us"
+         << "Square, us" << '\n';
+    for (size_t size = 8; size <= 16384; size *= 2) {
+        BigInteger a = randomBigInteger(size, rd), b = randomBigInteger(size, rd);
+        cout << setw(14) << a.getSize();
+
+        BigInteger::karatsuba_threshold = never;
+        cout << setw(14);
+        if (size <= 4096) {
+            cout << measureMultiply(a, b) / 1000;
+        }
+        else {
+            cout << "-";
+        }
+
+        BigInteger::karatsuba_threshold = default_karatsuba;
+        BigInteger::ntt_threshold = never;
+        cout << setw(14) << measureMultiply(a, b) / 1000;
+
+        BigInteger::karatsuba_threshold = 0;
+        BigInteger::ntt_threshold = 0;
+        cout << setw(14) << measureMultiply(a, b) / 1000;
+
+        BigInteger::karatsuba_threshold = default_karatsuba;
+        BigInteger::ntt_threshold = default_ntt;
+        cout << measureMultiply(a, a) / 1000 << '\n';
+    }
+}
+
+// Average time of a / b, repeated until at least 20 ms have passed.
+long long measureDivide(const BigInteger &a, const BigInteger &b) {
+    long long elapsed = 0, count = 0;
+    while (elapsed < 20000000) {
+        BigInteger c = a;
+        auto time_start = chrono::steady_clock::now();
+        c /= b;
+        auto time_end = chrono::steady_clock::now();
+        elapsed += (time_end - time_start).count();
+        ++count;
+    }
+    return elapsed / count;
+}
+
+// Times division of 2n limbs by n limbs with and without the recursive algorithm,
+// next to an n by n multiplication.
+void benchmarkDivision() {
+    mt19937_64 rd(0);
+    const size_t default_burnikel_ziegler = BigInteger::burnikel_ziegler_threshold;
+
+    cout << setw(14) << left << "Limbs" << setw(14) << "Knuth, us" << setw(22) << "Burnikel-Ziegler, us"
+         << "Multiply, us" << '\n';
+    for (size_t size = 8; size <= 16384; size *= 2) {
+        BigInteger a = randomBigInteger(2 * size, rd), b = randomBigInteger(size, rd);
+        cout << setw(14) << b.getSize();
+
+        BigInteger::burnikel_ziegler_threshold = numeric_limits<size_t>::max();
+        cout << setw(14) << measureDivide(a, b) / 1000;
+        BigInteger::burnikel_ziegler_threshold = default_burnikel_ziegler;
+        cout << setw(22) << measureDivide(a, b) / 1000;
+        cout << measureMultiply(b, b) / 1000 << '\n';
+    }
+}
+
+// Times parsing and printing of numbers of the given decimal length next to squaring them.
+void benchmarkConversion() {
+    mt19937_64 rd(0);
+    uniform_int_distribution<int> ds_digit(0, 9);
+
+    cout << setw(14) << left << "Digits" << setw(14) << "Parse, ms" << setw(14) << "Print, ms" << "Square, ms" << '\n';
+    for (size_t size = 10000; size <= 10000000; size *= 10) {
+        string digits(size, '0');
+        for (auto &digit : digits) {
+            digit += ds_digit(rd);
+        }
+        digits[0] = '1';
+
+        auto time_start = chrono::steady_clock::now();
+        BigInteger a(digits);
+        auto time_end = chrono::steady_clock::now();
+        cout << setw(14) << size << setw(14) << (time_end - time_start).count() / 1000000;
+
+        time_start = chrono::steady_clock::now();
+        string printed = a.toString();
+        time_end = chrono::steady_clock::now();
+        cout << setw(14) << (time_end - time_start).count() / 1000000;
+
+        time_start = chrono::steady_clock::now();
+        a *= a;
+        time_end = chrono::steady_clock::now();
+        cout << (time_end - time_start).count() / 1000000 << (printed == digits ? "" : " (mismatch)") << '\n';
+    }
+}
+
+// Times workloads of mostly small numbers: random expressions on values of up to two
+// limbs, Pascal's triangle whose entries grow from one limb to a few dozen, and the same
+// binomial coefficients by the multiplicative formula.
+void benchmarkSmallValues() {
+    mt19937_64 rd(0);
+    uniform_int_distribution<long long> ds_value(1, 1000000000000ll);
+
+    cout << setw(28) << left << "Workload" << "Time, ms" << '\n';
+    auto time_start = chrono::steady_clock::now();
+    BigInteger total = 0;
+    for (size_t i = 0; i < 1000000; ++i) {
+        BigInteger a = ds_value(rd), b = ds_value(rd), c = ds_value(rd), d = ds_value(rd);
+        total += (a * b + c - d) / (c % d + 1) - a % b;
+    }
+    auto time_end = chrono::steady_clock::now();
+    cout << setw(28) << "Expressions, 10^6" << (time_end - time_start).count() / 1000000 << '\n';
+
+    time_start = chrono::steady_clock::now();
+    const size_t rows = 2000;
+    vector<BigInteger> row(rows + 1, 0);
+    row[0] = 1;
+    for (size_t n = 1; n <= rows; ++n) {
+        for (size_t k = n; k > 0; --k) {
+            row[k] += row[k - 1];
+        }
+    }
+    time_end = chrono::steady_clock::now();
+    cout << setw(28) << "Pascal's triangle, 2000" << (time_end - time_start).count() / 1000000 << '\n';
+
+    time_start = chrono::steady_clock::now();
+    size_t mismatches = 0;
+    for (long long n = 1; n <= (long long)rows; ++n) {
+        BigInteger binomial = 1;
+        for (long long k = 1; k <= n; ++k) {
+            binomial *= n - k + 1;
+            binomial /= k;
+            mismatches += n == (long long)rows && binomial != row[k];
+        }
+    }
+    time_end = chrono::steady_clock::now();
+    cout << setw(28) << "Binomials, n <= 2000" << (time_end - time_start).count() / 1000000
+         << (mismatches ? " (mismatch)" : "") << '\n';
+}
+
+// Times addition-bound loops: the Fibonacci numbers by a += b, and comparisons of the
+// last of them with a number that differs from it only in the lowest limb.
+void benchmarkAddition() {
+    cout << setw(14) << left << "Terms" << setw(14) << "Limbs" << setw(16) << "Fibonacci, ms" << "Compare, ns" << '\n';
+    for (size_t terms : {10000, 30000, 100000, 300000}) {
+        auto time_start = chrono::steady_clock::now();
+        BigInteger a = 0, b = 1;
+        for (size_t i = 0; i < terms; ++i) {
+            a += b;
+            swap(a, b);
+        }
+        auto time_end = chrono::steady_clock::now();
+        cout << setw(14) << terms << setw(14) << b.getSize() << setw(16) << (time_end - time_start).count() / 1000000;
+
+        //the operands alternate so that the comparison is not hoisted out of the loop
+        const BigInteger c = b + 1, *operands[] = {&b, &c};
+        const size_t repeats = 100000;
+        size_t less = 0;
+        time_start = chrono::steady_clock::now();
+        for (size_t i = 0; i < repeats; ++i) {
+            less += *operands[i & 1] < *operands[~i & 1];
+        }
+        time_end = chrono::steady_clock::now();
+        cout << (time_end - time_start).count() / repeats << (less == repeats / 2 ? "" : " (mismatch)") << '\n';
+    }
+}
+
+// Times multiplication on 1, 2, 4 and 8 threads, with the speedup over one thread; the
+// smaller sizes go through Karatsuba's scheme and the larger ones through the NTT.
+void benchmarkThreads() {
+    mt19937_64 rd(0);
+    const size_t thread_counts[] = {1, 2, 4, 8};
+
+    cout << "Hardware threads: " << thread::hardware_concurrency() << '\n';
+    cout << setw(14) << left << "Limbs";
+    for (size_t threads : thread_counts) {
+        cout << setw(20) << to_string(threads) + (threads == 1 ? " thread, us" : " threads, us");
+    }
+    cout << '\n';
+    for (size_t size : {1024, 2048, 65536, 1048576}) {
+        BigInteger a = randomBigInteger(size, rd), b = randomBigInteger(size, rd);
+        cout << setw(14) << a.getSize();
+
+        long long single = 0;
+        for (size_t threads : thread_counts) {
+            BigInteger::multiply_threads = threads;
+            long long elapsed = measureMultiply(a, b);
+            if (threads == 1) {
+                single = elapsed;
+            }
+            ostringstream cell;
+            cell << elapsed / 1000 << " (" << fixed << setprecision(2) << (double)single / elapsed << "x)";
+            cout << setw(20) << cell.str();
+        }
+        cout << '\n';
+    }
+    BigInteger::multiply_threads = 1;
+}
+
+// base^exponent mod modulus by binary exponentiation with operator%= after every product.
+BigInteger powmodByRemainder(BigInteger base, const BigInteger &exponent, const BigInteger &modulus) {
+    BigInteger result = 1;
+    base %= modulus;
+    for (size_t i = 64 * exponent.getSize(); i > 0; --i) {
+        result *= result;
+        result %= modulus;
+        if (exponent.getDigit((i - 1) / 64) >> ((i - 1) % 64) & 1) {
+            result *= base;
+            result %= modulus;
+        }
+    }
+    return result % modulus;
+}
+
+// Times powmod against binary exponentiation with operator%= for an odd (Montgomery's
+// reduction) and an even (Barrett's reduction) modulus, with an exponent as long as the modulus.
+void benchmarkPowmod() {
+    mt19937_64 rd(0);
+
+    cout << setw(14) << left << "Bits" << setw(14) << "*= %=, us" << setw(16) << "Montgomery, us" << "Barrett, us" << '\n';
+    for (size_t bits = 512; bits <= 8192; bits *= 2) {
+        BigInteger odd = randomBigInteger(bits / 64, rd), base = randomBigInteger(bits / 64, rd);
+        BigInteger exponent = randomBigInteger(bits / 64, rd);
+        if (odd % 2 == 0) {
+            ++odd;
+        }
+        BigInteger even = odd - 1;
+
+        auto time_start = chrono::steady_clock::now();
+        BigInteger expected = powmodByRemainder(base, exponent, odd);
+        auto time_end = chrono::steady_clock::now();
+        cout << setw(14) << 64 * odd.getSize() << setw(14) << (time_end - time_start).count() / 1000;
+
+        time_start = chrono::steady_clock::now();
+        BigInteger result = powmod(base, exponent, odd);
+        time_end = chrono::steady_clock::now();
+        cout << setw(16) << (time_end - time_start).count() / 1000;
+        bool match = result == expected;
+
+        time_start = chrono::steady_clock::now();
+        result = powmod(base, exponent, even);
+        time_end = chrono::steady_clock::now();
+        match = match && result == powmodByRemainder(base, exponent, even);
+        cout << (time_end - time_start).count() / 1000 << (match ? "" : " (mismatch)") << '\n';
+    }
+}
+
+// Checks multiplication, division, printing and powmod with every threshold at or near its
+// smallest value, so that the recursive algorithms reach their base cases on short numbers:
+// products against naiveMultiply, quotients by a = q b + r with |r| < |b|, printing by
+// parsing back and powmod against powmodByRemainder. Returns the number of mismatches.
+size_t checkSmallThresholds(size_t count) {
+    mt19937_64 rd(0);
+    const size_t default_karatsuba = BigInteger::karatsuba_threshold, default_ntt = BigInteger::ntt_threshold;
+    const size_t default_burnikel_ziegler = BigInteger::burnikel_ziegler_threshold;
+
+    size_t mismatches = 0;
+    for (size_t threshold = 0; threshold <= 4; ++threshold) {
+        BigInteger::karatsuba_threshold = threshold;
+        BigInteger::ntt_threshold = 4 * threshold;
+        BigInteger::burnikel_ziegler_threshold = threshold;
+        for (size_t i = 0; i < count; ++i) {
+            BigInteger a = randomBigInteger(1 + rd() % 40, rd), b = randomBigInteger(1 + rd() % 20, rd);
+            if (rd() % 2) {
+                a = -a;
+            }
+            if (rd() % 2) {
+                b = -b;
+            }
+
+            BigInteger product = a, expected = a;
+            product *= b;
+            expected.naiveMultiply(b);
+            mismatches += product != expected;
+
+            BigInteger quotient = a / b, remainder = a % b;
+            BigInteger magnitude = remainder < 0 ? -remainder : remainder, divisor = b < 0 ? -b : b;
+            mismatches += quotient * b + remainder != a || magnitude >= divisor;
+
+            mismatches += BigInteger(a.toString()) != a;
+
+            BigInteger modulus = divisor + rd() % 2, exponent = randomBigInteger(1 + rd() % 2, rd);
+            BigInteger base = a < 0 ? -a : a;
+            mismatches += powmod(base, exponent, modulus) != powmodByRemainder(base, exponent, modulus);
+        }
+    }
+    BigInteger::karatsuba_threshold = default_karatsuba;
+    BigInteger::ntt_threshold = default_ntt;
+    BigInteger::burnikel_ziegler_threshold = default_burnikel_ziegler;
+    return mismatches;
+}
+
+int main(int argc, char **argv) {
+    if (argc > 1 && string(argv[1]) == "--benchmark-thresholds") {
+        benchmarkThresholds();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-division") {
+        benchmarkDivision();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-conversion") {
+        benchmarkConversion();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-small") {
+        benchmarkSmallValues();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-addition") {
+        benchmarkAddition();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-threads") {
+        benchmarkThreads();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--benchmark-powmod") {
+        benchmarkPowmod();
+        return 0;
+    }
+    if (argc > 1 && string(argv[1]) == "--check-thresholds") {
+        size_t mismatches = checkSmallThresholds(argc > 2 ? stoul(argv[2]) : 1000);
+        cout << "Mismatches with small thresholds: " << mismatches << '\n';
+        return mismatches != 0;
+    }
+
+    const size_t tries = 13;
+    const size_t size = 10000;
+
+    mt19937_64 rd(chrono::system_clock::now().time_since_epoch().count());
+    uniform_int_distribution<int> ds_digit('0', '9');
+
+    long long karatsuba_time = 0, naive_time = 0;
+
+    for (int i = 0; i < tries; ++i) {
+        string iss_str;
+        auto delimiter = size / 2;
+        for (size_t j = 0; j < size; ++j) {
+            if (j == delimiter) {
+                iss_str.push_back(' ');
+            }
+            if ((j == delimiter || j == 0) && rd() % 2) {
+                iss_str.push_back('-');
+            }
+            iss_str.push_back((char)ds_digit(rd));
+        }
+        istringstream iss(iss_str);
+        BigInteger a, b, c, d;
+        iss >> a >> b;
+        c = a;
+        d = b;
+
+        auto time_start = chrono::steady_clock::now();
+        a *= b;
+        auto time_end = chrono::steady_clock::now();
+
+        karatsuba_time += (time_end - time_start).count();
+
+        time_start = chrono::steady_clock::now();
+        a.naiveMultiply(b);
+        time_end = chrono::steady_clock::now();
+
+        naive_time += (time_end - time_start).count();
+    }
+    cout << setw(14) << left << "Time"        << setw(14) << "Overall"      << "Average"              << '\n';
+    cout << setw(14) << left << "Karatsuba's" << setw(14) << karatsuba_time << karatsuba_time / tries << '\n';
+    cout << setw(14) << left << "Naive"       << setw(14) << naive_time     << naive_time / tries     << '\n';
+    cout << '\n';
+    cout << "Karatsuba's " << (double)naive_time / karatsuba_time << " times faster." << '\n';
+
+    return 0;
+}
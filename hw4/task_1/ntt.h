@@ -0,0 +1,212 @@
+#pragma once
+
+#include <vector>
+#include <cstdint>
+#include <cstddef>
+#include <algorithm>
+#include <thread>
+#include "../../common/Parallel.h"
+
+// Multiplication of 64-bit limb arrays by number theoretic transforms modulo three
+// primes of the form c * 2^k + 1. Limbs are split into 32-bit pieces, so a coefficient
+// of the product is a sum of at most 2 min(n, m) products below 2^64. Within the
+// longest supported transform that is below 2^86, and the Chinese remainder theorem
+// restores it exactly modulo 998244353 * 167772161 * 469762049 > 2^86.
+
+template<uint32_t Mod, uint32_t Generator>
+struct NttPrime {
+    static const uint32_t mod = Mod;
+
+    static uint32_t multiply(uint32_t a, uint32_t b) {
+        return (uint64_t)a * b % Mod;
+    }
+
+    static uint32_t power(uint32_t base, uint64_t exponent) {
+        uint32_t result = 1;
+        for (; exponent; exponent >>= 1) {
+            if (exponent & 1)
+                result = multiply(result, base);
+            base = multiply(base, base);
+        }
+        return result;
+    }
+
+    static void transform(uint32_t *a, size_t n, bool inverse, std::vector<uint32_t> &roots, size_t threads = 1);
+};
+
+// The forward transform leaves the result in bit-reversed order and the inverse one
+// takes it in that order, which is all a convolution needs, so no permutation is done.
+// Long stages split their butterflies between the threads, short ones their blocks.
+template<uint32_t Mod, uint32_t Generator>
+void NttPrime<Mod, Generator>::transform(uint32_t *a, size_t n, bool inverse, std::vector<uint32_t> &roots,
+                                         size_t threads) {
+    //powers of the root of unity of order 2 half at [half, 2 half) of the first half
+    //of roots, and floor(power * 2^32 / Mod) at the same places of the second half for
+    //Shoup's multiplication by a constant, which needs no division
+    roots.resize(2 * std::max<size_t>(n, 2));
+    uint32_t *powers = roots.data(), *quotients = roots.data() + n;
+    for (size_t half = 1; half < n; half <<= 1) {
+        uint32_t root = power(Generator, (Mod - 1) / (2 * half));
+        powers[half] = 1;
+        for (size_t i = 1; i < half; ++i)
+            powers[half + i] = multiply(powers[half + i - 1], root);
+        for (size_t i = 0; i < half; ++i)
+            quotients[half + i] = (uint32_t)(((uint64_t)powers[half + i] << 32) / Mod);
+    }
+
+    auto multiply_by_root = [&](uint32_t x, size_t index) {
+        uint32_t result = x * powers[index] - (uint32_t)((uint64_t)x * quotients[index] >> 32) * Mod;
+        return result >= Mod ? result - Mod : result;
+    };
+    //decimation in frequency: natural order in, bit-reversed out
+    auto forward_butterflies = [&](uint32_t *low, size_t first, size_t last, size_t half) {
+        uint32_t *high = low + half;
+        for (size_t i = first; i < last; ++i) {
+            uint32_t u = low[i], v = high[i];
+            low[i] = u + v >= Mod ? u + v - Mod : u + v;
+            high[i] = multiply_by_root(u >= v ? u - v : u + Mod - v, half + i);
+        }
+    };
+    //decimation in time: bit-reversed order in, natural out
+    auto inverse_butterflies = [&](uint32_t *low, size_t first, size_t last, size_t half) {
+        uint32_t *high = low + half;
+        for (size_t i = first; i < last; ++i) {
+            uint32_t u = low[i], v = multiply_by_root(high[i], half + i);
+            low[i] = u + v >= Mod ? u + v - Mod : u + v;
+            high[i] = u >= v ? u - v : u + Mod - v;
+        }
+    };
+    //one stage over all n / 2 butterflies, which are numbered group by group
+    auto long_stage = [&](size_t half, const auto &butterflies) {
+        splitBetweenThreads(n / 2, threads, [&](size_t from, size_t to) {
+            for (size_t k = from; k < to;) {
+                size_t first = k % half, last = std::min(half, first + (to - k));
+                butterflies(a + k / half * 2 * half, first, last, half);
+                k += last - first;
+            }
+        });
+    };
+
+    //short stages go block by block while a block stays in cache
+    const size_t block = std::min<size_t>(n, 1 << 13);
+    if (!inverse) {
+        for (size_t half = n / 2; half >= block; half >>= 1)
+            long_stage(half, forward_butterflies);
+        splitBetweenThreads(n / block, threads, [&](size_t from, size_t to) {
+            for (size_t start = from * block; start < to * block; start += block)
+                for (size_t half = block / 2; half >= 1; half >>= 1)
+                    for (size_t group = start; group < start + block; group += 2 * half)
+                        forward_butterflies(a + group, 0, half, half);
+        });
+        return;
+    }
+
+    splitBetweenThreads(n / block, threads, [&](size_t from, size_t to) {
+        for (size_t start = from * block; start < to * block; start += block)
+            for (size_t half = 1; half < block; half <<= 1)
+                for (size_t group = start; group < start + block; group += 2 * half)
+                    inverse_butterflies(a + group, 0, half, half);
+    });
+    for (size_t half = block; half < n; half <<= 1)
+        long_stage(half, inverse_butterflies);
+
+    //with the forward roots this is the transform by the inverse root with the outputs
+    //but the first reversed
+    std::reverse(a + 1, a + n);
+    uint32_t n_inverse = power((uint32_t)(n % Mod), Mod - 2);
+    for (size_t i = 0; i < n; ++i)
+        a[i] = multiply(a[i], n_inverse);
+}
+
+typedef NttPrime<998244353, 3> NttPrime1;
+typedef NttPrime<167772161, 3> NttPrime2;
+typedef NttPrime<469762049, 3> NttPrime3;
+
+// Longest transform all three primes support; 998244353 - 1 = 119 * 2^23.
+const size_t NTT_MAX_LENGTH = (size_t)1 << 23;
+
+// Whether nttMultiply can multiply operands of these sizes in limbs.
+inline bool nttFits(size_t n, size_t m) {
+    return 2 * (n + m) <= NTT_MAX_LENGTH;
+}
+
+// Cyclic convolution of the 32-bit pieces of a and b modulo one prime, in place in
+// pieces; b_pieces is used as scratch. A square takes one forward transform less.
+template<typename Prime>
+void nttConvolve(const uint64_t *a, size_t n, const uint64_t *b, size_t m, size_t length,
+                 std::vector<uint32_t> &pieces, std::vector<uint32_t> &b_pieces, std::vector<uint32_t> &roots,
+                 size_t threads) {
+    auto split = [length](const uint64_t *limbs, size_t size, std::vector<uint32_t> &result) {
+        result.assign(length, 0);
+        for (size_t i = 0; i < size; ++i) {
+            result[2 * i] = (uint32_t)limbs[i] % Prime::mod;
+            result[2 * i + 1] = (uint32_t)(limbs[i] >> 32) % Prime::mod;
+        }
+    };
+    split(a, n, pieces);
+    Prime::transform(pieces.data(), length, 0, roots, threads);
+    if (a == b && n == m) {
+        for (size_t i = 0; i < length; ++i)
+            pieces[i] = Prime::multiply(pieces[i], pieces[i]);
+    }
+    else {
+        split(b, m, b_pieces);
+        Prime::transform(b_pieces.data(), length, 0, roots, threads);
+        for (size_t i = 0; i < length; ++i)
+            pieces[i] = Prime::multiply(pieces[i], b_pieces[i]);
+    }
+    Prime::transform(pieces.data(), length, 1, roots, threads);
+}
+
+// result[0, n + m) = a[0, n) * b[0, m); requires nttFits(n, m). With three threads or
+// more the primes go on threads of their own and share the rest for their transforms.
+inline void nttMultiply(const uint64_t *a, size_t n, const uint64_t *b, size_t m, uint64_t *result,
+                        size_t threads = 1) {
+    size_t length = 1;
+    while (length < 2 * (n + m))
+        length <<= 1;
+
+    std::vector<uint32_t> first, second, third;
+    if (threads >= 3) {
+        size_t share = threads / 3;
+        std::thread second_worker([&] {
+            std::vector<uint32_t> scratch, roots;
+            nttConvolve<NttPrime2>(a, n, b, m, length, second, scratch, roots, share);
+        });
+        std::thread third_worker([&] {
+            std::vector<uint32_t> scratch, roots;
+            nttConvolve<NttPrime3>(a, n, b, m, length, third, scratch, roots, share);
+        });
+        std::vector<uint32_t> scratch, roots;
+        nttConvolve<NttPrime1>(a, n, b, m, length, first, scratch, roots, threads - 2 * share);
+        second_worker.join();
+        third_worker.join();
+    }
+    else {
+        std::vector<uint32_t> scratch, roots;
+        nttConvolve<NttPrime1>(a, n, b, m, length, first, scratch, roots, threads);
+        nttConvolve<NttPrime2>(a, n, b, m, length, second, scratch, roots, threads);
+        nttConvolve<NttPrime3>(a, n, b, m, length, third, scratch, roots, threads);
+    }
+
+    //Garner's algorithm: x = r1 + m1 * (v2 + m2 * v3)
+    const uint32_t m1 = NttPrime1::mod, m2 = NttPrime2::mod;
+    const uint32_t m1_inverse_2 = NttPrime2::power(m1 % NttPrime2::mod, NttPrime2::mod - 2);
+    const uint32_t m1m2_inverse_3 = NttPrime3::power(NttPrime3::multiply(m1 % NttPrime3::mod, m2 % NttPrime3::mod),
+                                                     NttPrime3::mod - 2);
+
+    unsigned __int128 carry = 0;
+    for (size_t i = 0; i < 2 * (n + m); ++i) {
+        uint32_t r1 = first[i], r2 = second[i], r3 = third[i];
+        uint32_t v2 = NttPrime2::multiply((r2 + NttPrime2::mod - r1 % NttPrime2::mod) % NttPrime2::mod, m1_inverse_2);
+        uint32_t x12_3 = (uint32_t)((r1 + (uint64_t)m1 % NttPrime3::mod * v2) % NttPrime3::mod);
+        uint32_t v3 = NttPrime3::multiply((r3 + NttPrime3::mod - x12_3) % NttPrime3::mod, m1m2_inverse_3);
+        carry += r1 + (uint64_t)m1 * v2 + (unsigned __int128)((uint64_t)m1 * m2) * v3;
+        uint32_t piece = (uint32_t)carry;
+        carry >>= 32;
+        if (i % 2 == 0)
+            result[i / 2] = piece;
+        else
+            result[i / 2] |= (uint64_t)piece << 32;
+    }
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <random>
+#include <cmath>
+
+// All corpora use lowercase latin letters only: AhoCorasickTrie indexes its
+// children by c - 'a'. Every generator is deterministic for a given seed.
+
+inline std::string uniformCorpus(size_t size, unsigned long long seed) {
+    std::mt19937_64 rd(seed);
+    std::uniform_int_distribution<int> ds_char('a', 'z');
+    std::string corpus(size, 0);
+    for (auto& c : corpus) {
+        c = (char)ds_char(rd);
+    }
+    return corpus;
+}
+
+inline std::string fibonacciCorpus(size_t size, unsigned long long) {
+    std::string previous = "a", current = "ab";
+    while (current.size() < size) {
+        std::string next = current + previous;
+        previous = std::move(current);
+        current = std::move(next);
+    }
+    current.resize(size);
+    return current;
+}
+
+inline std::string thueMorseCorpus(size_t size, unsigned long long) {
+    std::string corpus(size, 0);
+    for (size_t i = 0; i < size; ++i) {
+        corpus[i] = __builtin_parityll(i) ? 'b' : 'a';
+    }
+    return corpus;
+}
+
+// Random nucleotides with occasional copies of earlier fragments, which is what
+// makes real genomes hard for suffix structures.
+inline std::string dnaCorpus(size_t size, unsigned long long seed) {
+    const char nucleotides[] = "acgt";
+    std::mt19937_64 rd(seed);
+    std::string corpus;
+    corpus.reserve(size);
+    while (corpus.size() < size) {
+        if (corpus.size() > 1000 && rd() % 8 == 0) {
+            size_t length = 50 + rd() % 500;
+            size_t from = rd() % (corpus.size() - length);
+            for (size_t i = 0; i < length && corpus.size() < size; ++i) {
+                corpus.push_back(corpus[from + i]);
+            }
+        }
+        else {
+            corpus.push_back(nucleotides[rd() % 4]);
+        }
+    }
+    return corpus;
+}
+
+// Words of a random vocabulary drawn with Zipf's law; words are glued together
+// since the alphabet has no separator.
+inline std::string naturalLanguageCorpus(size_t size, unsigned long long seed) {
+    const size_t vocabulary_size = 5000;
+    const char letters[] = "eeeeeeeeeeeettttttttaaaaaaaoooooooiiiiiiinnnnnnsssssshhhhhhrrrrrrddddlllluuucccmmmwwffggyyppbbvkjxqz";
+    std::mt19937_64 rd(seed);
+    std::vector<std::string> vocabulary(vocabulary_size);
+    std::vector<double> weights(vocabulary_size);
+    for (size_t i = 0; i < vocabulary_size; ++i) {
+        size_t length = 1 + rd() % 3 + rd() % 4 + rd() % 4;
+        for (size_t j = 0; j < length; ++j) {
+            vocabulary[i].push_back(letters[rd() % (sizeof(letters) - 1)]);
+        }
+        weights[i] = 1. / (i + 1);
+    }
+    std::discrete_distribution<size_t> ds_word(weights.begin(), weights.end());
+    std::string corpus;
+    corpus.reserve(size + 16);
+    while (corpus.size() < size) {
+        corpus += vocabulary[ds_word(rd)];
+    }
+    corpus.resize(size);
+    return corpus;
+}
@@ -0,0 +1,198 @@
+#include <iostream>
+#include <iomanip>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include <vector>
+#include <functional>
+#include <chrono>
+#include <atomic>
+#include <cstdlib>
+#include <new>
+#include "Corpora.h"
+#include "../hw1/task_1/PrefixFunction.h"
+#include "../hw1/task_2/ZFunction.h"
+#include "../hw1/task_3/AhoCorasickTrie.h"
+#include "../hw2/task_1/SuffixArrayWithLCP.h"
+#include "../hw2/task_1/OnlineSubstringCounter.h"
+#include "../hw2/task_2/TwoSuffixTree.h"
+
+using namespace std;
+
+static atomic<size_t> allocation_count(0);
+static atomic<size_t> allocated_bytes(0);
+
+void *operator new(size_t size) {
+    ++allocation_count;
+    allocated_bytes += size;
+    if (void *pointer = malloc(size ? size : 1)) {
+        return pointer;
+    }
+    throw bad_alloc();
+}
+
+void operator delete(void *pointer) noexcept {
+    free(pointer);
+}
+
+void operator delete(void *pointer, size_t) noexcept {
+    free(pointer);
+}
+
+// Peak resident set size in KiB. Writing 5 to clear_refs resets the peak on Linux,
+// so that every engine gets its own measurement; elsewhere the peak is cumulative.
+void resetPeakRss() {
+    ofstream("/proc/self/clear_refs") << "5";
+}
+
+size_t peakRss() {
+    ifstream status("/proc/self/status");
+    string line;
+    while (getline(status, line)) {
+        if (line.compare(0, 6, "VmHWM:") == 0) {
+            return stoull(line.substr(6));
+        }
+    }
+    return 0;
+}
+
+struct Corpus {
+    string name;
+    function<string(size_t, unsigned long long)> generate;
+};
+
+// prepare() does the untimed setup for a corpus and returns the timed run,
+// which returns a checksum so the work cannot be optimized away.
+struct Engine {
+    string name;
+    function<function<size_t()>(const string &)> prepare;
+};
+
+vector<Engine> engines() {
+    return {
+        {"kmp", [](const string &corpus) {
+            string pattern = corpus.substr(corpus.size() / 2, 16);
+            return function<size_t()>([&corpus, pattern]() {
+                return findOccurrences(corpus, pattern).size();
+            });
+        }},
+        {"z_search", [](const string &corpus) {
+            string pattern = corpus.substr(corpus.size() / 2, 16);
+            return function<size_t()>([&corpus, pattern]() {
+                return findOccurrencesZ(corpus, pattern).size();
+            });
+        }},
+        {"aho_corasick", [](const string &corpus) {
+            vector<string> patterns;
+            for (size_t i = 1; i <= 16; ++i) {
+                patterns.push_back(corpus.substr(corpus.size() * i / 17, 4 + i % 8));
+            }
+            return function<size_t()>([&corpus, patterns]() {
+                AhoCorasickTrie trie;
+                for (size_t i = 0; i < patterns.size(); ++i) {
+                    trie.addPatternToTrie(patterns[i], i);
+                }
+                size_t matches = 0;
+                for (char c : corpus) {
+                    matches += trie.traverseLetter(c).size();
+                }
+                return matches;
+            });
+        }},
+        {"suffix_array_lcp", [](const string &corpus) {
+            return function<size_t()>([&corpus]() {
+                SuffixArrayWithLCP suf(corpus);
+                return suf[0] + suf.lcp(corpus.size() / 2);
+            });
+        }},
+        {"two_suffix_tree", [](const string &corpus) {
+            string first = corpus.substr(0, corpus.size() / 2) + "$";
+            string second = corpus.substr(corpus.size() / 2) + "#";
+            return function<size_t()>([first, second]() {
+                TwoSuffixTree tree(first, second);
+                return tree.getNodeCount();
+            });
+        }},
+        {"online_substring_counter", [](const string &corpus) {
+            return function<size_t()>([&corpus]() {
+                OnlineSubstringCounter counter(corpus.size());
+                for (char c : corpus) {
+                    counter.append(c);
+                }
+                return counter.differentSubstrings();
+            });
+        }},
+        {"prefix_to_z", [](const string &corpus) {
+            vector<int> prefix = stringToPrefix(corpus);
+            return function<size_t()>([prefix]() {
+                return (size_t)prefixToZ(prefix).back();
+            });
+        }},
+        {"prefix_to_z_linear", [](const string &corpus) {
+            vector<int> prefix = stringToPrefix(corpus);
+            return function<size_t()>([prefix]() {
+                return (size_t)prefixToZLinear(prefix).back();
+            });
+        }},
+    };
+}
+
+int main(int argc, char **argv) {
+    const size_t size = argc > 1 ? stoull(argv[1]) : 1 << 18;
+    const unsigned long long seed = argc > 2 ? stoull(argv[2]) : 42;
+    const string output_path = argc > 3 ? argv[3] : "strings_benchmark.csv";
+    const size_t tries = 3;
+
+    const vector<Corpus> corpora = {
+        {"uniform", uniformCorpus},
+        {"fibonacci", fibonacciCorpus},
+        {"thue_morse", thueMorseCorpus},
+        {"dna", dnaCorpus},
+        {"natural_language", naturalLanguageCorpus},
+    };
+
+    ofstream csv(output_path);
+    csv << "engine,corpus,size,seed,tries,best_ns,ns_per_byte,mb_per_s,peak_rss_kb,allocations,allocated_bytes,checksum\n";
+
+    cout << setw(26) << left << "Engine" << setw(18) << "Corpus" << setw(14) << "ns/byte"
+         << setw(12) << "MB/s" << setw(16) << "Peak RSS, KiB" << setw(14) << "Allocations" << '\n';
+
+    for (const auto &corpus_generator : corpora) {
+        const string corpus = corpus_generator.generate(size, seed);
+        for (const auto &engine : engines()) {
+            auto run = engine.prepare(corpus);
+
+            long long best_time = -1;
+            size_t checksum = 0, allocations = 0, bytes = 0, rss = 0;
+            for (size_t i = 0; i < tries; ++i) {
+                resetPeakRss();
+                size_t allocations_start = allocation_count, bytes_start = allocated_bytes;
+
+                auto time_start = chrono::steady_clock::now();
+                checksum = run();
+                auto time_end = chrono::steady_clock::now();
+
+                long long time = (time_end - time_start).count();
+                if (best_time < 0 || time < best_time) {
+                    best_time = time;
+                }
+                allocations = allocation_count - allocations_start;
+                bytes = allocated_bytes - bytes_start;
+                rss = max(rss, peakRss());
+            }
+
+            double ns_per_byte = (double)best_time / size;
+            double mb_per_s = best_time ? size * 1e3 / best_time : 0;
+
+            cout << setw(26) << left << engine.name << setw(18) << corpus_generator.name
+                 << setw(14) << setprecision(4) << ns_per_byte << setw(12) << mb_per_s
+                 << setw(16) << rss << setw(14) << allocations << '\n';
+            csv << engine.name << ',' << corpus_generator.name << ',' << size << ',' << seed << ','
+                << tries << ',' << best_time << ',' << ns_per_byte << ',' << mb_per_s << ','
+                << rss << ',' << allocations << ',' << bytes << ',' << checksum << '\n';
+        }
+    }
+
+    cout << '\n' << "Results written to " << output_path << '\n';
+    return 0;
+}